@@ -0,0 +1,108 @@
+import os
+import sys
+import json
+import random
+import shutil
+import tempfile
+import subprocess
+from walksat import walksat, kernel, gather_kernel, prefetch_distance
+
+PREFETCH_DISTANCE_LIST = [0, 4, 8] # WALKSAT_PREFETCH_DISTANCE of the builds the prefetch sweep compares, 0 compiles the hints out
+
+
+def random_formula(num_variables: int, ratio: float, k: int, seed: int) -> list[list[int]]:
+    # uniform random k-sat, no locality to exploit
+    rng = random.Random(seed)
+    return [
+        [rng.choice([-1, +1]) * v for v in rng.sample(range(1, num_variables + 1), k)]
+        for _ in range(int(ratio * num_variables))
+    ]
+
+
+def local_formula(num_variables: int, ratio: float, k: int, window: int, seed: int) -> list[list[int]]:
+    # random k-sat over a sliding window of vars, numbered at random like the output of an encoder
+    rng = random.Random(seed)
+    perm = list(range(1, num_variables + 1))
+    rng.shuffle(perm)
+    formula = []
+    for _ in range(int(ratio * num_variables)):
+        start = rng.randrange(num_variables - window)
+        formula.append([rng.choice([-1, +1]) * perm[v] for v in rng.sample(range(start, start + window), k)])
+    return formula
+
+
+def run(formula: list[list[int]], max_time_s: int, **kwargs) -> tuple[float, int]:
+    stats = {}
+    hard_cost, _, _ = walksat(formula=formula, max_time_s=max_time_s, stats=stats, preprocess=False, **kwargs)
+    return stats["num_flips"] / stats["search_time_s"], hard_cost
+
+
+def make_instance_list() -> list[tuple[str, list[list[int]]]]:
+    return [
+        ("random 3-sat n=200000", random_formula(200000, 4.2, 3, 1)),
+        ("local 3-sat n=200000", local_formula(200000, 4.2, 3, 50, 1)),
+    ]
+
+
+CONFIG_LIST = [
+    ("walksat", dict(engine="walksat", rand_var_prob=0.5)),
+    ("probsat", dict(engine="probsat")),
+]
+
+
+def run_flips(max_time_s: int):
+    # flips/s of every instance and config with this build, as json for run_prefetch
+    result = {"prefetch_distance": prefetch_distance(), "flips_per_s": {}}
+    for instance_name, formula in make_instance_list():
+        for config_name, config in CONFIG_LIST:
+            result["flips_per_s"][f"{instance_name:24} {config_name:10}"], _ = run(formula, max_time_s, **config)
+    print(json.dumps(result))
+
+
+def run_prefetch(max_time_s: int):
+    # build the extension once per prefetch distance next to a copy of this script, so that the copy imports that build
+    root = os.path.dirname(os.path.abspath(__file__))
+    flips_list = []
+    for distance in PREFETCH_DISTANCE_LIST:
+        with tempfile.TemporaryDirectory() as build_dir:
+            env = dict(os.environ, CFLAGS=f"{os.environ.get('CFLAGS', '')} -DWALKSAT_PREFETCH_DISTANCE={distance}")
+            subprocess.run(
+                [sys.executable, "setup.py", "build", "--force", f"--build-lib={build_dir}", f"--build-temp={os.path.join(build_dir, 'temp')}"],
+                cwd=root, env=env, check=True, stdout=subprocess.DEVNULL,
+            )
+            shutil.copy(os.path.abspath(__file__), build_dir)
+            output = subprocess.run(
+                [sys.executable, os.path.join(build_dir, os.path.basename(__file__)), str(max_time_s), "flips"],
+                cwd=build_dir, check=True, stdout=subprocess.PIPE, text=True,
+            ).stdout
+        result = json.loads(output.strip().split("\n")[-1])
+        assert result["prefetch_distance"] == distance, f"build of prefetch distance {distance} reports {result['prefetch_distance']}"
+        flips_list.append(result["flips_per_s"])
+    for name, base in flips_list[0].items():
+        line = f"{name} flips/s"
+        for distance, flips in zip(PREFETCH_DISTANCE_LIST, flips_list):
+            line += f" distance {distance} {flips[name]:10.0f} ({flips[name] / base - 1:+.1%})"
+        print(line)
+
+
+def run_reorder(max_time_s: int):
+    for instance_name, formula in make_instance_list():
+        for config_name, config in CONFIG_LIST:
+            base, _ = run(formula, max_time_s, reorder=False, **config)
+            reordered, _ = run(formula, max_time_s, reorder=True, **config)
+            print(f"{instance_name:24} {config_name:10} flips/s {base:12.0f} reordered {reordered:12.0f} gain {reordered / base - 1:+.1%}")
+
+
+if __name__ == "__main__":
+    # python benchmark.py [max_time_s] [reorder|prefetch], reorder compares reorder on and off in this build,
+    # prefetch builds the extension for every distance of PREFETCH_DISTANCE_LIST and compares their flips/s
+    max_time_s = int(sys.argv[1]) if len(sys.argv) > 1 else 5
+    mode = sys.argv[2] if len(sys.argv) > 2 else "reorder"
+    if mode == "flips":
+        run_flips(max_time_s)
+        sys.exit(0)
+    print(f"kernel {kernel()} gather kernel {gather_kernel()} prefetch distance {prefetch_distance()}")
+    if mode == "prefetch":
+        run_prefetch(max_time_s)
+    else:
+        run_reorder(max_time_s)
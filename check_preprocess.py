@@ -0,0 +1,77 @@
+import sys
+import random
+import itertools
+from walksat import walksat
+
+
+def random_instance(rng: random.Random) -> tuple[list[list[int]], list[float], list[bool], int]:
+    # small partial maxsat with unit, binary and ternary clauses, equivalences give substitution and elimination work
+    num_variables = rng.randint(3, 10)
+    formula = [
+        [rng.choice([-1, +1]) * v for v in rng.sample(range(1, num_variables + 1), rng.randint(1, 3))]
+        for _ in range(rng.randint(3, 30))
+    ]
+    for _ in range(rng.randint(0, 3)):
+        a, b = rng.sample(range(1, num_variables + 1), 2)
+        sign = rng.choice([-1, +1])
+        formula.append([a, -sign * b])
+        formula.append([-a, sign * b])
+    weight = [float(rng.choice([1, 2, 5])) for _ in formula]
+    hard = [rng.random() < 0.5 for _ in formula]
+    return formula, weight, hard, num_variables
+
+
+def cost(formula: list[list[int]], weight: list[float], hard: list[bool], assignment: list[int]) -> tuple[int, float]:
+    hard_cost, soft_cost = 0, 0.0
+    for clause, w, h in zip(formula, weight, hard):
+        if not any(literal * assignment[abs(literal)] > 0 for literal in clause):
+            if h:
+                hard_cost += 1
+            else:
+                soft_cost += w
+    return hard_cost, soft_cost
+
+
+def optimum(formula: list[list[int]], weight: list[float], hard: list[bool], num_variables: int) -> tuple[int, float]:
+    return min(
+        cost(formula, weight, hard, [0] + list(assignment))
+        for assignment in itertools.product([-1, +1], repeat=num_variables)
+    )
+
+
+if __name__ == "__main__":
+    # preprocessing (units, subsumption, equivalent literals, elimination) must reconstruct an assignment of the
+    # original formula whose cost is the one reported, and keep the optimum reachable when the hard clauses are
+    # satisfiable, the simplifications only keep models of the hard clauses
+    num_instances = int(sys.argv[1]) if len(sys.argv) > 1 else 300
+    rng = random.Random(11)
+    num_failed = 0
+    num_feasible = 0
+    num_eliminated_vars = 0
+    num_equivalent_vars = 0
+    for i in range(num_instances):
+        formula, weight, hard, num_variables = random_instance(rng)
+        best = optimum(formula, weight, hard, num_variables)
+        result = None
+        for seed in range(3):
+            stats = {}
+            # max_time_s=0 stops at the first time check, a fixed budget of flips that finds the optimum of these sizes
+            hard_cost, soft_cost, assignment = walksat(
+                formula=formula, weight=weight, hard=hard, seed=seed, max_time_s=0,
+                engine="walksat", rand_var_prob=0.4, preprocess=True, stats=stats,
+            )
+            num_eliminated_vars += stats["num_eliminated_vars"]
+            num_equivalent_vars += stats["num_equivalent_vars"]
+            if cost(formula, weight, hard, assignment) != (hard_cost, soft_cost):
+                print(f"instance {i} seed {seed}: reported cost {(hard_cost, soft_cost)} but the assignment costs {cost(formula, weight, hard, assignment)}")
+                num_failed += 1
+            result = (hard_cost, soft_cost) if result is None else min(result, (hard_cost, soft_cost))
+        if best[0] > 0:
+            continue
+        num_feasible += 1
+        if result != best:
+            print(f"instance {i}: best cost {result}, optimum {best}, formula {formula} weight {weight} hard {hard}")
+            num_failed += 1
+    print(f"{num_instances} instances, {num_feasible} with satisfiable hard clauses, {num_eliminated_vars} eliminated vars, {num_equivalent_vars} equivalent vars, {num_failed} failed")
+    assert num_eliminated_vars > 0 and num_equivalent_vars > 0, "instances do not exercise elimination and substitution"
+    sys.exit(1 if num_failed > 0 else 0)
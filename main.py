@@ -3,6 +3,7 @@ from typing import Iterator
 from walksat import walksat
 from mpi_runner import run_task, Task, MPI_Comm
 
+MAX_TIME_S = 5 # search time of every worker
 
 
 def parse_dimacs(formula_dimacs: str) -> Iterator[list[list[int]]]:
@@ -37,38 +38,55 @@ class MyTask(Task):
     size: int
     formula: list[list[int]]
     weight: list[float]
+    hard: list[bool]
+    target_cost: float
+    best_cost: tuple[int, float]
     seed: int
     step: int
     def setup(self, comm = None):
         self.size = comm.get_size()
         self.formula = list(parse_dimacs(formula_dimacs=open(sys.argv[1]).read()))[0]
         self.weight = [1.0 for _ in range(len(self.formula))]
-        self.weight[2] = 0
+        self.weight[2] = 0.0 # clause 2 does not count
+        self.hard = [False for _ in range(len(self.formula))] # every clause is soft
+        self.target_cost = float(sys.argv[2]) if len(sys.argv) > 2 else 0.0
+        self.best_cost = (len(self.formula) + 1, 0.0)
     
     def produce(self):
-        for i in range(1 * (self.size - 1)): # 1 job for each worker
-            yield self.formula, self.weight
+        # 1 job for each worker, one search keeps improving its assignment for the whole MAX_TIME_S,
+        # it stops by itself at the target and done() keeps any further job from being sent
+        for i in range(1 * (self.size - 1)):
+            yield self.formula, self.weight, self.hard, self.target_cost, MAX_TIME_S
     
     def consume(self, result):
-        best_num_unsat_clauses, assign = result
-        print(best_num_unsat_clauses)
+        hard_cost, soft_cost, assign = result
+        self.best_cost = min(self.best_cost, (hard_cost, soft_cost))
+        print(hard_cost, soft_cost)
+
+    def done(self):
+        hard_cost, soft_cost = self.best_cost
+        return hard_cost == 0 and soft_cost <= self.target_cost
 
     def setup_worker(self, comm = None):
         self.seed = comm.get_rank() + 1000
         self.step = comm.get_size() - 1
 
     def apply(self, item):
-        formula, weight = item
+        formula, weight, hard, target_cost, max_time_s = item
         print(f"running walksat with seed {self.seed}")
-        best_num_unsat_clauses, assignment = walksat(
+        hard_cost, soft_cost, assignment = walksat(
             formula=formula,
             weight=weight,
+            hard=hard,
             seed=self.seed,
-            max_time_s=5,
-            rand_var_prob=0.1,
+            max_time_s=max_time_s,
+            engine="adaptive_novelty",
+            rand_var_prob=0.01, # random walk probability, the noise adapts by itself
+            target_cost=target_cost,
+            num_threads=1, # every MPI worker already has its own core
         )
         self.seed += self.step
-        return best_num_unsat_clauses, assignment
+        return hard_cost, soft_cost, assignment
 
 if __name__ == "__main__":
     from mpi4py import MPI
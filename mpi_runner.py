@@ -18,7 +18,7 @@ class Task:
     master process:
     task.setup(comm)
     item_list = list(task.produce())
-    worker_pool.send(item_list)
+    worker_pool.send(item_list) # stop sending once task.done()
     for result in worker_pool.recv():
         task.consume(result)
     task.finalize(comm)
@@ -40,6 +40,10 @@ class Task:
         raise NotImplemented
     def consume(self, result: Any):
         raise NotImplemented
+    def done(self) -> bool:
+        # return True to stop dispatching the remaining items, e.g. a good enough result was consumed,
+        # items already running are not interrupted
+        return False
     def apply(self, item: Any) -> Any:
         raise NotImplemented
     def setup_worker(self, comm: Comm | None = None):
@@ -56,6 +60,8 @@ def run_task(task: Task, comm: Comm | None = None):
         task.setup()
         task.setup_worker(comm)
         for item in task.produce():
+            if task.done():
+                break
             result = task.apply(item)
             task.consume(result)
         task.finalize_worker()
@@ -76,6 +82,8 @@ def run_task(task: Task, comm: Comm | None = None):
         def emit_task(q_emit: queue.Queue, q_send: queue.Queue, q_recv: queue.Queue):
             for data in data_iter:
                 worker = q_emit.get()
+                if task.done(): # results consumed so far are good enough
+                    break
                 q_send.put((worker, data))
                 
             for worker in range(1, comm.get_size()):
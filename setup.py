@@ -19,6 +19,13 @@ if __name__ == "__main__":
                 name=f"{MODULE}.wrapper",
                 sources=[
                     os.path.join(MODULE, "src", "walksat.cpp"),
+                    os.path.join(MODULE, "src", "preprocess.cpp"),
+                    os.path.join(MODULE, "src", "component.cpp"),
+                    os.path.join(MODULE, "src", "reorder.cpp"),
+                    os.path.join(MODULE, "src", "arena.cpp"),
+                    os.path.join(MODULE, "src", "eval.cpp"),
+                    os.path.join(MODULE, "src", "multiwalk.cpp"),
+                    os.path.join(MODULE, "src", "cpu.cpp"),
                     os.path.join(MODULE, "wrapper.pyx")
                 ],
                 language="c++",
@@ -27,7 +34,10 @@ if __name__ == "__main__":
                     os.path.join(MODULE, "inc"),
                 ],
                 extra_compile_args=[
-                    "-std=c++11", "-stdlib=libc++", "-g", "-O0",
+                    "-std=c++11", "-stdlib=libc++", "-O2", "-pthread",
+                ],
+                extra_link_args=[
+                    "-pthread",
                 ],
             )
         ],
@@ -1 +1 @@
-from .wrapper import walksat
\ No newline at end of file
+from .wrapper import walksat, kernel, gather_kernel, prefetch_distance
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+#include<stdint.h>
+#include<stddef.h>
+#include<type_traits>
+#include<vector>
+
+const uint64_t CACHE_LINE_SIZE = 64;
+const uint64_t HUGE_PAGE_SIZE = uint64_t(2) << 20; // transparent huge page on x86-64 and most arm64 kernels
+
+// arena - one block that the arrays of a search are carved from, released all at once with the arena,
+// allocations that do not fit go to the heap
+struct arena {
+    char* data;
+    uint64_t size;
+    uint64_t used;
+    uint64_t num_allocations; // allocations so far, from the block or the heap
+    bool huge_pages; // the block and heap allocations of a huge page or more ask for transparent huge pages
+    arena() : data(nullptr), size(0), used(0), num_allocations(0), huge_pages(false) {}
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    ~arena();
+};
+
+// init_arena - block of size bytes, arrays must not be carved from the arena before
+void init_arena(arena& arena, uint64_t size, bool huge_pages);
+
+// heap_allocate - size bytes on a multiple of alignment, with huge_pages blocks of a huge page or more
+// start on a huge page and are advised to the kernel as huge page backed (MADV_HUGEPAGE), if the kernel
+// cannot, they are ordinary memory
+void* heap_allocate(uint64_t size, uint64_t alignment, bool huge_pages);
+
+// arena_allocate - size bytes on a multiple of alignment, from the heap if arena is nullptr or full
+void* arena_allocate(arena* arena, uint64_t size, uint64_t alignment, bool huge_pages);
+
+// arena_deallocate - memory of the block is released with the arena, heap memory right away
+void arena_deallocate(arena* arena, void* p);
+
+// arena_alignment - arrays start on a cache line, or on the alignment of T if it is larger
+template<typename T> constexpr uint64_t arena_alignment() {
+    return alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE;
+}
+
+// arena_array_size - room an array of n T takes in an arena
+template<typename T> uint64_t arena_array_size(uint64_t n) {
+    uint64_t alignment = arena_alignment<T>();
+    return (n * sizeof(T) + alignment - 1) / alignment * alignment;
+}
+
+// huge_page_bytes - bytes the kernel backs with huge pages in the mappings holding the blocks at
+// address_list, each mapping counted once, 0 where /proc/self/smaps is not available
+uint64_t huge_page_bytes(const std::vector<const void*>& address_list);
+
+// arena_allocator - allocator of arena_vector, without an arena it allocates aligned memory from the heap,
+// std::allocator only guarantees over-aligned storage from C++17
+template<typename T> struct arena_allocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    struct arena* pool;
+    bool huge_pages; // heap allocations of a huge page or more ask for huge pages
+    arena_allocator() : pool(nullptr), huge_pages(false) {}
+    explicit arena_allocator(struct arena* pool) : pool(pool), huge_pages(pool->huge_pages) {}
+    explicit arena_allocator(bool huge_pages) : pool(nullptr), huge_pages(huge_pages) {}
+    template<typename U> arena_allocator(const arena_allocator<U>& other) : pool(other.pool), huge_pages(other.huge_pages) {}
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_allocate(pool, n * sizeof(T), arena_alignment<T>(), huge_pages));
+    }
+    void deallocate(T* p, size_t) {
+        arena_deallocate(pool, p);
+    }
+};
+
+template<typename T, typename U> bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return a.pool == b.pool and a.huge_pages == b.huge_pages;
+}
+
+template<typename T, typename U> bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+    return not (a == b);
+}
+
+template<typename T> using arena_vector = std::vector<T, arena_allocator<T>>;
+
+#endif //_ARENA_H_
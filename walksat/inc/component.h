@@ -0,0 +1,42 @@
+#ifndef _COMPONENT_H_
+#define _COMPONENT_H_
+#include"problem.h"
+#include<atomic>
+#include<mutex>
+
+// find_components - connected components of the var-clause graph, var_component[v] is the component of var v,
+// returns the number of components
+uint64_t find_components(const problem& problem, std::vector<uint64_t>& var_component);
+
+// split_components - one problem per component with its vars renumbered,
+// component_var_list[i][v] is the var of problem that is var v of component i
+void split_components(const problem& problem, const std::vector<uint64_t>& var_component, uint64_t num_components, std::vector<struct problem>& component_list, std::vector<std::vector<var_t>>& component_var_list);
+
+// component_target - best costs of the components of a problem searched one after another or at the same time,
+// every search reports its improvements and stops once the costs of all components add up to the target
+struct component_target {
+    weight_t target_weight;
+    std::mutex mutex; // guards the best costs and their sums
+    std::vector<uint64_t> best_hard; // best cost of every component, the max of uint64_t until it reports one
+    std::vector<weight_t> best_weight;
+    uint64_t num_reported; // components with a best cost
+    uint64_t sum_hard;
+    weight_t sum_weight;
+    std::atomic<bool> reached;
+};
+
+// component_search - the component a search reports to target as, and the assignment it starts from,
+// empty for the initial assignment of the config
+struct component_search {
+    component_target* target;
+    uint64_t component;
+    assign_t initial_assignment;
+};
+
+void init_component_target(component_target& target, weight_t target_weight, uint64_t num_components);
+
+// report_component_best - new best cost of a component, ignored unless it improves on the one reported before,
+// returns true once the target is reached
+bool report_component_best(component_target& target, uint64_t component, uint64_t hard, weight_t weight);
+
+#endif //_COMPONENT_H_
@@ -0,0 +1,20 @@
+#ifndef _CPU_H_
+#define _CPU_H_
+#include<stdint.h>
+
+// WALKSAT_MULTIVERSION - compile a hot function for AVX-512, AVX2, SSE4.2 and baseline x86-64, the dynamic loader
+// binds the variant of the cpu once (ifunc), so one build runs well everywhere. Without ifunc (not ELF, older
+// compilers, other architectures) the function is compiled once for the build target
+#if defined(__x86_64__) && defined(__ELF__) && ((defined(__clang__) && __clang_major__ >= 14) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define WALKSAT_MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#define WALKSAT_MULTIVERSION_ENABLED 1
+#else
+#define WALKSAT_MULTIVERSION
+#define WALKSAT_MULTIVERSION_ENABLED 0
+#endif
+
+// cpu_level - walksat_kernel the cpu supports, in the order the loader binds WALKSAT_MULTIVERSION variants,
+// detected once
+uint64_t cpu_level();
+
+#endif //_CPU_H_
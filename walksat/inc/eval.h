@@ -0,0 +1,12 @@
+#ifndef _EVAL_H_
+#define _EVAL_H_
+#include"problem.h"
+
+// LIT_TRUTH_PADDING - bytes lit_truth has past its last literal, the vector kernels read 4 bytes at a time
+const uint64_t LIT_TRUTH_PADDING = 3;
+
+// sat_literal_vars - sat_var[j] is the var of literal first[j] if it is sat and 0 otherwise, lit_truth is -1
+// at lit_index of sat literals and 0 elsewhere, the AVX-512, AVX2 or scalar kernel is picked once by walksat_gather_kernel
+void sat_literal_vars(const lit_t* first, const lit_t* last, const int8_t* lit_truth, var_t* sat_var);
+
+#endif //_EVAL_H_
@@ -0,0 +1,17 @@
+#ifndef _MULTIWALK_H_
+#define _MULTIWALK_H_
+#include"problem.h"
+#include"walksat.h"
+#include"component.h"
+#include<chrono>
+
+const uint64_t MULTIWALK_LANES = 64; // assignments searched at once, one bit of a machine word each
+
+// multiwalk_search_problem - WalkSAT on MULTIWALK_LANES independent assignments packed into the bits of one word
+// per var, every clause is evaluated for all lanes at once with bitwise operations while each lane picks its
+// own clause and var with its own random numbers. Search until a lane meets the target or the deadline passes,
+// return the best assignment of any lane, stats.num_flips counts the flips of every lane. The search of a component
+// of a larger problem reports its best costs to search->target and also stops once that is reached
+assign_t multiwalk_search_problem(const problem& problem, const walksat_config& config, weight_t target_weight, std::chrono::steady_clock::time_point deadline, walksat_stats& stats, const component_search* search);
+
+#endif //_MULTIWALK_H_
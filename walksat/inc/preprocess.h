@@ -0,0 +1,30 @@
+#ifndef _PREPROCESS_H_
+#define _PREPROCESS_H_
+#include"walksat.h"
+#include"problem.h"
+#include<chrono>
+
+// elimination_step - var removed from the problem, its value is set during reconstruction
+struct elimination_step {
+    var_t var;
+    lit_t equal_lit; // var takes the value of this literal, 0 if var was eliminated by resolution
+    std::vector<clause_t> clause_list; // hard clauses of var removed by resolution, var is set to satisfy them
+};
+
+struct preprocess_map {
+    uint64_t num_variables; // of the original problem
+    std::vector<var_t> var_list; // original var of each var of the reduced problem, index 0 unused
+    assign_t fixed_assignment; // value of original vars fixed by preprocessing, 0 if free
+    uint64_t fixed_hard; // hard clauses falsified by preprocessing
+    weight_t fixed_weight; // weight of soft clauses falsified by preprocessing
+    std::vector<elimination_step> elimination_stack; // undone last to first
+};
+
+// preprocess_problem - normalize and simplify original into reduced, map translates assignments of reduced back.
+// The simplifications stop at deadline
+void preprocess_problem(const problem& original, const walksat_config& config, std::chrono::steady_clock::time_point deadline, problem& reduced, preprocess_map& map, walksat_stats& stats);
+
+// reconstruct_assignment - assignment of the original problem from an assignment of the reduced problem
+void reconstruct_assignment(const preprocess_map& map, const assign_t& reduced_assignment, assign_t& assignment);
+
+#endif //_PREPROCESS_H_
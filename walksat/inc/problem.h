@@ -0,0 +1,74 @@
+#ifndef _PROBLEM_H_
+#define _PROBLEM_H_
+#include"arena.h"
+#include<stdint.h>
+#include<vector>
+
+using var_t = uint64_t;
+using lit_t = int64_t;
+using clause_t = std::vector<lit_t>;
+using weight_t = int64_t; // soft weights are scaled to integers so that costs are exact
+using val_t = int8_t; // 0, -1, +1
+using assign_t = std::vector<val_t>;
+
+// lit_index - index of literal into occurrence lists, +var at 2*var and -var at 2*var+1
+inline uint64_t lit_index(lit_t lit) {
+    return lit > 0 ? 2 * uint64_t(lit) : 2 * uint64_t(-lit) + 1;
+}
+
+// list_view - one list of a flat (CSR) array of a problem
+template<typename T> struct list_view {
+    const T* first;
+    const T* last;
+    uint64_t size() const { return last - first; }
+    const T& operator[](uint64_t i) const { return first[i]; }
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+};
+
+// clause_view - literals of one clause in the clause store of a problem
+using clause_view = list_view<lit_t>;
+
+struct problem {
+    arena_vector<lit_t> lit_list; // literals of every clause back to back (CSR)
+    arena_vector<uint64_t> clause_start; // clause c is lit_list from clause_start[c] up to clause_start[c+1]
+    std::vector<weight_t> weight_list; // weight of soft clauses, unused for hard clauses
+    std::vector<bool> hard_list; // hard clauses must be satisfied
+    arena_vector<uint64_t> occur_list; // clause indices grouped by the literals they contain (CSR)
+    arena_vector<uint64_t> occur_start; // literal l has occur_list from occur_start[lit_index(l)] up to occur_start[lit_index(l)+1]
+    bool huge_pages; // the arrays above ask for transparent huge pages once they take one
+    uint64_t num_variables;
+    uint64_t num_clauses;
+    uint64_t num_hard_clauses;
+};
+
+// get_clause -
+inline clause_view get_clause(const problem& problem, uint64_t c) {
+    clause_view clause;
+    clause.first = problem.lit_list.data() + problem.clause_start[c];
+    clause.last = problem.lit_list.data() + problem.clause_start[c + 1];
+    return clause;
+}
+
+// get_occur - clauses containing lit
+inline list_view<uint64_t> get_occur(const problem& problem, lit_t lit) {
+    list_view<uint64_t> occur;
+    occur.first = problem.occur_list.data() + problem.occur_start[lit_index(lit)];
+    occur.last = problem.occur_list.data() + problem.occur_start[lit_index(lit) + 1];
+    return occur;
+}
+
+// init_problem - problem without clauses, with room for num_clauses clauses of num_literals literals in total
+// so that push_clause does not reallocate
+void init_problem(problem& problem, uint64_t num_variables, uint64_t num_clauses, uint64_t num_literals, bool huge_pages);
+
+// push_clause - append clause with literals from first up to last
+void push_clause(problem& problem, const lit_t* first, const lit_t* last, weight_t weight, bool hard);
+
+// make_occur_list - index every clause by the literals it contains
+void make_occur_list(problem& problem);
+
+// search_huge_page_bytes - huge page backed bytes of the mappings holding the arrays of problem and the search arena
+uint64_t search_huge_page_bytes(const problem& problem, const arena& pool);
+
+#endif //_PROBLEM_H_
@@ -0,0 +1,10 @@
+#ifndef _REORDER_H_
+#define _REORDER_H_
+#include"problem.h"
+
+// reorder_problem - renumber vars in breadth first order over the clauses (Cuthill-McKee) and store clauses in the
+// order they are reached, so that vars and clauses updated by the same flip are close in memory,
+// var_list[v] is the var of problem that is var v of reordered
+void reorder_problem(const problem& problem, struct problem& reordered, std::vector<var_t>& var_list);
+
+#endif //_REORDER_H_
@@ -4,6 +4,123 @@
 
 
 extern "C" {
-    double c_walksat(uint64_t seed, uint64_t max_time_s, double rand_var_prob, uint64_t num_variables, uint64_t num_clauses, int64_t* formula_flatten, double* clause_weight, int8_t* assignment);
+    enum walksat_engine {
+        WALKSAT_ENGINE_WALKSAT = 0, // greedy or random var in unsat clause, static weights
+        WALKSAT_ENGINE_WEIGHTING = 1, // dynamic clause weighting
+        WALKSAT_ENGINE_PROBSAT = 2, // var in unsat clause with probability by its break count
+        WALKSAT_ENGINE_NOVELTY = 3, // Novelty+, avoids the most recently flipped var of the clause
+        WALKSAT_ENGINE_ADAPTIVE_NOVELTY = 4, // Adaptive Novelty+, noise adjusted on stagnation
+        WALKSAT_ENGINE_CC = 5, // configuration checking with aspiration (CCAnr) and dynamic clause weighting
+        WALKSAT_ENGINE_MULTIWALK = 6, // 64 independent WalkSAT walks in the bits of one word per var, for small formulas
+    };
+
+    enum walksat_weighting {
+        WALKSAT_WEIGHTING_PAWS = 0, // additive increase, periodic decrease
+        WALKSAT_WEIGHTING_SAPS = 1, // multiplicative increase, probabilistic smoothing
+        WALKSAT_WEIGHTING_DDFW = 2, // weight transfer from satisfied neighbours
+        WALKSAT_WEIGHTING_SWT = 3, // additive increase, smoothing once the mean weight exceeds a threshold (CCAnr)
+    };
+
+    enum walksat_probsat {
+        WALKSAT_PROBSAT_AUTO = 0, // polynomial for clauses up to width 3, exponential for wider clauses
+        WALKSAT_PROBSAT_POLY = 1, // (eps + break)^-cb
+        WALKSAT_PROBSAT_EXP = 2, // cb^-break
+    };
+
+    enum walksat_init {
+        WALKSAT_INIT_RANDOM = 0, // every var true or false with a coin flip
+        WALKSAT_INIT_POLARITY = 1, // polarity with the most weighted occurrences
+        WALKSAT_INIT_GREEDY = 2, // satisfy clauses one by one, hard, short and heavy first
+    };
+
+    enum walksat_restart {
+        WALKSAT_RESTART_NONE = 0,
+        WALKSAT_RESTART_LUBY = 1, // restart_base * luby(i) flips
+        WALKSAT_RESTART_GEOMETRIC = 2, // restart_base * restart_factor^i flips
+        WALKSAT_RESTART_STAGNATION = 3, // restart_base flips without improving the best cost
+    };
+
+    enum walksat_restart_init {
+        WALKSAT_RESTART_INIT_RANDOM = 0, // new random assignment
+        WALKSAT_RESTART_INIT_BEST = 1, // best assignment so far (phase saving)
+        WALKSAT_RESTART_INIT_PERTURB = 2, // best assignment with restart_perturb of the vars flipped at random
+    };
+
+    enum walksat_kernel {
+        WALKSAT_KERNEL_SCALAR = 0, // baseline build, or a cpu without the extensions below
+        WALKSAT_KERNEL_SSE42 = 1,
+        WALKSAT_KERNEL_AVX2 = 2,
+        WALKSAT_KERNEL_AVX512 = 3, // AVX-512F
+    };
+
+    struct walksat_config {
+        uint64_t seed;
+        double max_time_s; // budget of the whole call, setup included
+        double rand_var_prob; // probability of picking random var, the random walk probability of Novelty+
+        double target_cost; // stop once no hard clause is unsat and soft cost is at most this value
+        uint64_t engine; // walksat_engine
+        uint64_t weighting; // walksat_weighting, used by WALKSAT_ENGINE_WEIGHTING and WALKSAT_ENGINE_CC
+        uint64_t probsat_function; // walksat_probsat, used by WALKSAT_ENGINE_PROBSAT
+        double probsat_cb; // base of the break function, 0 for the default per clause width
+        double novelty_noise; // probability of picking the second best var, used by WALKSAT_ENGINE_NOVELTY
+        uint64_t tabu_tenure; // a var flipped less than this many flips ago is not flipped again unless it gives a new best, 0 disables
+        uint64_t tabu_adaptive; // lengthen the tenure on stagnation and shorten it back on improvement
+        uint64_t walksat_promising; // WALKSAT_ENGINE_WALKSAT flips the best promising improving var first (G2WSAT)
+        uint64_t init; // walksat_init, initial assignment
+        uint64_t restart_policy; // walksat_restart
+        uint64_t restart_base; // flips, see walksat_restart
+        double restart_factor; // growth of WALKSAT_RESTART_GEOMETRIC intervals
+        uint64_t restart_init; // walksat_restart_init
+        double restart_perturb; // fraction of vars flipped by WALKSAT_RESTART_INIT_PERTURB
+        uint64_t preprocess; // simplify the problem before search, 0 disables
+        uint64_t reorder; // renumber vars and clauses in breadth first order for memory locality, 0 disables
+        uint64_t num_threads; // threads searching independent components in parallel, 0 for every hardware thread
+        uint64_t huge_pages; // back the clause store, occurrence lists and search state with transparent huge pages, 0 disables
+        double preprocess_max_time_s; // time budget of preprocessing, every pass stops once it is used up
+    };
+
+    struct walksat_stats {
+        uint64_t hard_cost; // number of unsat hard clauses
+        double soft_cost; // weighted sum of unsat soft clauses
+        double weight_scale; // soft weights are multiplied by this and rounded to integers during search
+        uint64_t num_flips; // flips of every lane for WALKSAT_ENGINE_MULTIWALK
+        uint64_t num_tabu_blocked; // candidate vars skipped because they were tabu
+        uint64_t num_promising_flips; // flips taken from the promising vars instead of an unsat clause
+        uint64_t num_restarts;
+        double search_time_s; // time spent flipping, summed over the threads
+        uint64_t num_lanes; // assignments searched at once, 64 for WALKSAT_ENGINE_MULTIWALK and 1 otherwise
+        double lane_flips_per_s; // num_flips / search_time_s
+        uint64_t num_search_allocations; // allocations made while flipping, 0 unless an array outgrew its room
+        uint64_t huge_page_bytes; // bytes of the search arrays the kernel backed with huge pages, summed over the components
+        uint64_t initial_hard_cost; // cost of the initial assignment
+        double initial_soft_cost;
+        uint64_t num_duplicate_literals; // repeated literals dropped from clauses
+        uint64_t num_tautologies; // clauses containing both x and -x, dropped
+        uint64_t num_duplicate_clauses; // clauses merged into an identical clause of the same kind
+        uint64_t num_unit_vars; // vars fixed by unit propagation
+        uint64_t num_pure_vars; // vars fixed as pure literals
+        uint64_t num_subsumed_clauses; // hard clauses removed because a hard clause subsumes them
+        uint64_t num_strengthened_literals; // literals removed from hard clauses by self-subsuming resolution
+        uint64_t num_equivalent_vars; // vars replaced by an equivalent literal
+        uint64_t num_eliminated_vars; // vars eliminated by resolution
+        uint64_t preprocess_conflict; // preprocessing proved the hard clauses unsatisfiable and was undone
+        uint64_t preprocess_timeout; // a preprocessing pass stopped at its deadline, the rest of the problem is kept as is
+        uint64_t num_reduced_variables; // size of the problem handed to local search
+        uint64_t num_reduced_clauses;
+        uint64_t num_components; // connected components of the reduced problem, searched independently
+    };
+
+    // walksat_kernel_variant - walksat_kernel of the WALKSAT_MULTIVERSION hot loops the loader bound for this cpu,
+    // WALKSAT_KERNEL_SCALAR if the build has no target_clones
+    uint64_t walksat_kernel_variant();
+
+    // walksat_gather_kernel - walksat_kernel of the sat literal gather of eval_solution picked for this cpu,
+    // WALKSAT_KERNEL_SCALAR, WALKSAT_KERNEL_AVX2 or WALKSAT_KERNEL_AVX512
+    uint64_t walksat_gather_kernel();
+
+    // walksat_prefetch_distance - WALKSAT_PREFETCH_DISTANCE the library was built with, 0 if prefetching is compiled out
+    uint64_t walksat_prefetch_distance();
+
+    double c_walksat(const walksat_config* config, uint64_t num_variables, uint64_t num_clauses, int64_t* formula_flatten, double* clause_weight, int8_t* clause_hard, int8_t* assignment, walksat_stats* stats);
 }
-#endif // _WALKSAT_H_ 
\ No newline at end of file
+#endif // _WALKSAT_H_
@@ -0,0 +1,90 @@
+#include"arena.h"
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<new>
+#include<sys/mman.h>
+
+arena::~arena() {
+    free(data);
+}
+
+void init_arena(arena& arena, uint64_t size, bool huge_pages) {
+    free(arena.data);
+    arena.data = nullptr;
+    arena.size = 0;
+    arena.used = 0;
+    arena.huge_pages = huge_pages;
+    if (size == 0) {
+        return;
+    }
+    try {
+        arena.data = static_cast<char*>(heap_allocate(size, CACHE_LINE_SIZE, huge_pages));
+        arena.size = size;
+    } catch (const std::bad_alloc&) {
+        // every array goes to the heap instead
+    }
+}
+
+void* heap_allocate(uint64_t size, uint64_t alignment, bool huge_pages) {
+    void* p = nullptr;
+    if (huge_pages and size >= HUGE_PAGE_SIZE) {
+        // whole huge pages so that the advice covers no other allocation
+        uint64_t huge_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (posix_memalign(&p, HUGE_PAGE_SIZE, huge_size) == 0) {
+#ifdef MADV_HUGEPAGE
+            madvise(p, huge_size, MADV_HUGEPAGE); // only advice, ordinary pages if it fails
+#endif
+            return p;
+        }
+    }
+    if (posix_memalign(&p, alignment, size > 0 ? size : alignment) != 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* arena_allocate(arena* arena, uint64_t size, uint64_t alignment, bool huge_pages) {
+    if (arena != nullptr) {
+        arena->num_allocations++;
+        uint64_t first = (arena->used + alignment - 1) / alignment * alignment;
+        if (arena->data != nullptr and first + size <= arena->size) {
+            arena->used = first + size;
+            return arena->data + first;
+        }
+    }
+    return heap_allocate(size, alignment, huge_pages);
+}
+
+void arena_deallocate(arena* arena, void* p) {
+    if (arena != nullptr and arena->data != nullptr and static_cast<char*>(p) >= arena->data and static_cast<char*>(p) < arena->data + arena->size) {
+        return;
+    }
+    free(p);
+}
+
+uint64_t huge_page_bytes(const std::vector<const void*>& address_list) {
+    FILE* file = fopen("/proc/self/smaps", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    uint64_t total = 0;
+    bool holds_block = false; // the current mapping holds one of the blocks
+    char line[512];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        unsigned long long first = 0;
+        unsigned long long last = 0;
+        unsigned long long kb = 0;
+        if (sscanf(line, "%llx-%llx", &first, &last) == 2) { // a mapping starts
+            holds_block = false;
+            for (const void* address : address_list) {
+                uintptr_t a = reinterpret_cast<uintptr_t>(address);
+                holds_block = holds_block or (address != nullptr and a >= first and a < last);
+            }
+        } else if (holds_block and sscanf(line, "AnonHugePages: %llu kB", &kb) == 1) {
+            total += uint64_t(kb) << 10;
+        }
+    }
+    fclose(file);
+    return total;
+}
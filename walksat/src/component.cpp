@@ -0,0 +1,111 @@
+#include"component.h"
+#include<algorithm>
+#include<cstdlib>
+#include<limits>
+
+// find_root - root of the union-find tree of var, halving the path on the way
+var_t find_root(std::vector<var_t>& parent, var_t var) {
+    while (parent[var] != var) {
+        parent[var] = parent[parent[var]];
+        var = parent[var];
+    }
+    return var;
+}
+
+uint64_t find_components(const problem& problem, std::vector<uint64_t>& var_component) {
+    std::vector<var_t> parent(problem.num_variables + 1);
+    std::vector<uint64_t> tree_size(problem.num_variables + 1, 1);
+    for (var_t var=0; var <= problem.num_variables; var++) {
+        parent[var] = var;
+    }
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        clause_view clause = get_clause(problem, c);
+        for (uint64_t j=1; j < clause.size(); j++) {
+            var_t a = find_root(parent, abs(clause[0]));
+            var_t b = find_root(parent, abs(clause[j]));
+            if (a == b) {
+                continue;
+            }
+            if (tree_size[a] < tree_size[b]) {
+                std::swap(a, b);
+            }
+            parent[b] = a;
+            tree_size[a] += tree_size[b];
+        }
+    }
+    const uint64_t none = problem.num_variables + 1;
+    std::vector<uint64_t> root_component(problem.num_variables + 1, none);
+    var_component.assign(problem.num_variables + 1, 0);
+    uint64_t num_components = 0;
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        var_t root = find_root(parent, var);
+        if (root_component[root] == none) {
+            root_component[root] = num_components++;
+        }
+        var_component[var] = root_component[root];
+    }
+    return num_components;
+}
+
+void split_components(const problem& problem, const std::vector<uint64_t>& var_component, uint64_t num_components, std::vector<struct problem>& component_list, std::vector<std::vector<var_t>>& component_var_list) {
+    std::vector<var_t> component_var(problem.num_variables + 1, 0); // var in its component
+    component_var_list.assign(num_components, std::vector<var_t>(1, 0));
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        std::vector<var_t>& var_list = component_var_list[var_component[var]];
+        component_var[var] = var_list.size();
+        var_list.push_back(var);
+    }
+    std::vector<uint64_t> num_clauses(num_components, 0);
+    std::vector<uint64_t> num_literals(num_components, 0);
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        clause_view clause = get_clause(problem, c);
+        num_clauses[var_component[abs(clause[0])]]++;
+        num_literals[var_component[abs(clause[0])]] += clause.size();
+    }
+    component_list.resize(num_components);
+    for (uint64_t i=0; i < num_components; i++) {
+        init_problem(component_list[i], component_var_list[i].size() - 1, num_clauses[i], num_literals[i], problem.huge_pages);
+    }
+    clause_t clause;
+    for (uint64_t c=0; c < problem.num_clauses; c++) { // every clause has a literal after preprocessing
+        clause.clear();
+        for (lit_t lit : get_clause(problem, c)) {
+            lit_t var = lit_t(component_var[abs(lit)]);
+            clause.push_back(lit > 0 ? var : -var);
+        }
+        struct problem& component = component_list[var_component[abs(get_clause(problem, c)[0])]];
+        push_clause(component, clause.data(), clause.data() + clause.size(), problem.weight_list[c], problem.hard_list[c]);
+    }
+}
+
+void init_component_target(component_target& target, weight_t target_weight, uint64_t num_components) {
+    target.target_weight = target_weight;
+    target.best_hard.assign(num_components, std::numeric_limits<uint64_t>::max());
+    target.best_weight.assign(num_components, 0);
+    target.num_reported = 0;
+    target.sum_hard = 0;
+    target.sum_weight = 0;
+    target.reached = false;
+}
+
+bool report_component_best(component_target& target, uint64_t component, uint64_t hard, weight_t weight) {
+    std::lock_guard<std::mutex> lock(target.mutex);
+    uint64_t& best_hard = target.best_hard[component];
+    weight_t& best_weight = target.best_weight[component];
+    if (best_hard == std::numeric_limits<uint64_t>::max()) {
+        target.num_reported++;
+    } else if (hard > best_hard or (hard == best_hard and weight >= best_weight)) {
+        return target.reached;
+    } else {
+        target.sum_hard -= best_hard;
+        target.sum_weight -= best_weight;
+    }
+    best_hard = hard;
+    best_weight = weight;
+    target.sum_hard += hard;
+    target.sum_weight += weight;
+    if (target.num_reported == target.best_hard.size() and target.sum_hard == 0 and target.sum_weight <= target.target_weight) {
+        target.reached = true;
+    }
+    return target.reached;
+}
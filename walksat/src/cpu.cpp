@@ -0,0 +1,28 @@
+#include"cpu.h"
+#include"walksat.h"
+
+uint64_t detect_cpu_level() {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return WALKSAT_KERNEL_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return WALKSAT_KERNEL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return WALKSAT_KERNEL_SSE42;
+    }
+#endif
+    return WALKSAT_KERNEL_SCALAR;
+}
+
+uint64_t cpu_level() {
+    static const uint64_t level = detect_cpu_level();
+    return level;
+}
+
+uint64_t walksat_kernel_variant() {
+    // without target_clones every WALKSAT_MULTIVERSION function is the baseline build whatever the cpu
+    return WALKSAT_MULTIVERSION_ENABLED ? cpu_level() : uint64_t(WALKSAT_KERNEL_SCALAR);
+}
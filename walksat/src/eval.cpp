@@ -0,0 +1,96 @@
+#include"eval.h"
+#include"cpu.h"
+#include"walksat.h"
+#include<cstdlib>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define WALKSAT_X86_KERNELS
+#include<immintrin.h>
+#endif
+
+using sat_literal_vars_t = void (*)(const lit_t*, const lit_t*, const int8_t*, var_t*);
+
+void sat_literal_vars_scalar(const lit_t* first, const lit_t* last, const int8_t* lit_truth, var_t* sat_var) {
+    for (const lit_t* lit = first; lit != last; lit++) {
+        // -1 sign extends to a mask of every bit
+        *sat_var++ = var_t(abs(*lit)) & uint64_t(int64_t(lit_truth[lit_index(*lit)]));
+    }
+}
+
+#ifdef WALKSAT_X86_KERNELS
+
+// sat_literal_vars_avx2 - 4 literals at a time, their truth is gathered as 32 bit words of which the low byte counts
+__attribute__((target("avx2")))
+void sat_literal_vars_avx2(const lit_t* first, const lit_t* last, const int8_t* lit_truth, var_t* sat_var) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const int* base = reinterpret_cast<const int*>(lit_truth);
+    for (; last - first >= 4; first += 4, sat_var += 4) {
+        __m256i lit = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        __m256i neg = _mm256_cmpgt_epi64(zero, lit);
+        __m256i var = _mm256_sub_epi64(_mm256_xor_si256(lit, neg), neg);
+        __m256i index = _mm256_add_epi64(_mm256_slli_epi64(var, 1), _mm256_and_si256(neg, one));
+        __m128i truth = _mm256_i64gather_epi32(base, index, 1);
+        truth = _mm_srai_epi32(_mm_slli_epi32(truth, 24), 24);
+        __m256i mask = _mm256_cvtepi32_epi64(truth);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sat_var), _mm256_and_si256(var, mask));
+    }
+    sat_literal_vars_scalar(first, last, lit_truth, sat_var);
+}
+
+// sat_literal_vars_avx512 - 8 literals at a time, the tail with masked loads and stores
+__attribute__((target("avx512f")))
+void sat_literal_vars_avx512(const lit_t* first, const lit_t* last, const int8_t* lit_truth, var_t* sat_var) {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i low_byte = _mm512_set1_epi64(0xff);
+    const __m256i none = _mm256_setzero_si256();
+    while (first != last) {
+        uint64_t n = last - first < 8 ? last - first : 8;
+        __mmask8 lanes = __mmask8((1u << n) - 1);
+        __m512i lit = _mm512_maskz_loadu_epi64(lanes, first);
+        __mmask8 neg = _mm512_cmplt_epi64_mask(lit, zero);
+        __m512i var = _mm512_maskz_abs_epi64(lanes, lit);
+        __m512i twice = _mm512_maskz_slli_epi64(lanes, var, 1);
+        __m512i index = _mm512_mask_add_epi64(twice, neg, twice, one);
+        __m256i truth = _mm512_mask_i64gather_epi32(none, lanes, index, lit_truth, 1);
+        __mmask8 sat = _mm512_test_epi64_mask(_mm512_maskz_cvtepi32_epi64(lanes, truth), low_byte);
+        _mm512_mask_storeu_epi64(sat_var, lanes, _mm512_maskz_mov_epi64(sat, var));
+        first += n;
+        sat_var += n;
+    }
+}
+
+#endif
+
+uint64_t walksat_gather_kernel() {
+#ifdef WALKSAT_X86_KERNELS
+    switch (cpu_level()) {
+        case WALKSAT_KERNEL_AVX512:
+            return WALKSAT_KERNEL_AVX512;
+        case WALKSAT_KERNEL_AVX2:
+            return WALKSAT_KERNEL_AVX2;
+        default:
+            break;
+    }
+#endif
+    return WALKSAT_KERNEL_SCALAR;
+}
+
+sat_literal_vars_t select_sat_literal_vars() {
+    switch (walksat_gather_kernel()) {
+#ifdef WALKSAT_X86_KERNELS
+        case WALKSAT_KERNEL_AVX512:
+            return sat_literal_vars_avx512;
+        case WALKSAT_KERNEL_AVX2:
+            return sat_literal_vars_avx2;
+#endif
+        default:
+            return sat_literal_vars_scalar;
+    }
+}
+
+void sat_literal_vars(const lit_t* first, const lit_t* last, const int8_t* lit_truth, var_t* sat_var) {
+    static const sat_literal_vars_t kernel = select_sat_literal_vars();
+    kernel(first, last, lit_truth, sat_var);
+}
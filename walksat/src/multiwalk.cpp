@@ -0,0 +1,332 @@
+#include"multiwalk.h"
+#include"arena.h"
+#include"cpu.h"
+#include<vector>
+#include<random>
+#include<limits>
+#include<cstdlib>
+
+using steady_clock = std::chrono::steady_clock;
+using lane_mask = uint64_t; // bit l is lane l
+
+const uint64_t MULTIWALK_TIME_CHECK_PERIOD = 16; // steps between clock reads, a step flips up to MULTIWALK_LANES vars
+
+// clause_lanes - state of a clause in every lane
+struct clause_lanes {
+    lane_mask unsat; // lanes where no literal is sat
+    lane_mask one_sat; // lanes where exactly one literal is sat, its var breaks the clause
+    lane_mask listed; // lanes whose unsat list holds the clause, the entry may be stale
+};
+
+// lane_state - search state of one lane besides its bit of every var
+struct lane_state {
+    std::mt19937_64 engine;
+    arena_vector<uint64_t> unsat_hard_list; // unsat hard clauses, stale entries are removed when picked
+    arena_vector<uint64_t> unsat_soft_list; // unsat soft clauses, stale entries are removed before every pick
+    uint64_t cost_hard; // number of unsat hard clauses
+    weight_t cost_weight; // weighted sum of unsat soft clauses
+    uint64_t num_unsat_soft;
+};
+
+struct multiwalk {
+    arena_vector<lane_mask> value_list; // bit l of value_list[var] is the value of var in lane l, 1: true
+    arena_vector<clause_lanes> clause_list;
+    arena_vector<lane_mask> flip_mask; // lanes flipping var in the current step
+    arena_vector<var_t> flip_list; // vars flipped in the current step
+    std::vector<lane_state> lane_list;
+    std::uniform_real_distribution<double> dist_float01;
+};
+
+// lowest_lane - index of the lowest set bit of a non zero mask
+inline uint64_t lowest_lane(lane_mask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    uint64_t lane = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        lane++;
+    }
+    return lane;
+#endif
+}
+
+// lit_lanes - lanes where lit is sat, without a branch on the sign of lit that would be mispredicted half the time
+inline lane_mask lit_lanes(const multiwalk& walk, lit_t lit) {
+    return walk.value_list[abs(lit)] ^ lane_mask(lit >> 63);
+}
+
+// update_clause - state of clause c in every lane from the values, lanes where it turns unsat list it and pay for it
+void update_clause(const problem& problem, multiwalk& walk, uint64_t c) {
+    lane_mask sat = 0;
+    lane_mask sat_twice = 0;
+    for (lit_t lit : get_clause(problem, c)) {
+        lane_mask lanes = lit_lanes(walk, lit);
+        sat_twice |= sat & lanes;
+        sat |= lanes;
+    }
+    clause_lanes& state = walk.clause_list[c];
+    lane_mask became_unsat = ~sat & ~state.unsat;
+    lane_mask became_sat = sat & state.unsat;
+    state.unsat = ~sat;
+    state.one_sat = sat & ~sat_twice;
+    bool hard = problem.hard_list[c];
+    for (lane_mask m = became_unsat; m != 0; m &= m - 1) {
+        uint64_t l = lowest_lane(m);
+        lane_state& lane = walk.lane_list[l];
+        if (hard) {
+            lane.cost_hard++;
+        } else {
+            lane.cost_weight += problem.weight_list[c];
+            lane.num_unsat_soft++;
+        }
+        if ((state.listed >> l & 1) == 0) {
+            state.listed |= lane_mask(1) << l;
+            (hard ? lane.unsat_hard_list : lane.unsat_soft_list).push_back(c);
+        }
+    }
+    for (lane_mask m = became_sat; m != 0; m &= m - 1) {
+        lane_state& lane = walk.lane_list[lowest_lane(m)];
+        if (hard) {
+            lane.cost_hard--;
+        } else {
+            lane.cost_weight -= problem.weight_list[c];
+            lane.num_unsat_soft--;
+        }
+    }
+}
+
+// lane_pick_clause - random unsat hard clause of lane, or unsat soft clause by objective weight
+uint64_t lane_pick_clause(const problem& problem, multiwalk& walk, uint64_t l) {
+    lane_state& lane = walk.lane_list[l];
+    lane_mask bit = lane_mask(1) << l;
+    while (lane.cost_hard > 0) {
+        uint64_t i = uint64_t(walk.dist_float01(lane.engine) * lane.unsat_hard_list.size());
+        uint64_t c = lane.unsat_hard_list[i];
+        if (walk.clause_list[c].unsat & bit) {
+            return c;
+        }
+        // stale entry
+        walk.clause_list[c].listed &= ~bit;
+        lane.unsat_hard_list[i] = lane.unsat_hard_list.back();
+        lane.unsat_hard_list.pop_back();
+    }
+    weight_t sum_weight = 0;
+    for (uint64_t i=lane.unsat_soft_list.size(); i > 0; i--) {
+        uint64_t c = lane.unsat_soft_list[i-1];
+        if (walk.clause_list[c].unsat & bit) {
+            sum_weight += problem.weight_list[c];
+            continue;
+        }
+        walk.clause_list[c].listed &= ~bit;
+        lane.unsat_soft_list[i-1] = lane.unsat_soft_list.back();
+        lane.unsat_soft_list.pop_back();
+    }
+    if (sum_weight <= 0) { // every weight is zero, pick uniformly
+        return lane.unsat_soft_list[uint64_t(walk.dist_float01(lane.engine) * lane.unsat_soft_list.size())];
+    }
+    weight_t r = std::min(weight_t(walk.dist_float01(lane.engine) * sum_weight), sum_weight - 1);
+    for (uint64_t c : lane.unsat_soft_list) {
+        if (r < problem.weight_list[c]) {
+            return c;
+        }
+        r -= problem.weight_list[c];
+    }
+    return lane.unsat_soft_list.back();
+}
+
+// lane_break - hard clauses and soft weight that become unsat in lane l if var is flipped there
+void lane_break(const problem& problem, const multiwalk& walk, uint64_t l, var_t var, uint64_t& break_hard, weight_t& break_weight) {
+    lane_mask bit = lane_mask(1) << l;
+    lit_t sat_lit = walk.value_list[var] & bit ? lit_t(var) : -lit_t(var);
+    break_hard = 0;
+    break_weight = 0;
+    for (uint64_t c : get_occur(problem, sat_lit)) {
+        uint64_t breaks = walk.clause_list[c].one_sat >> l & 1;
+        if (problem.hard_list[c]) {
+            break_hard += breaks;
+        } else {
+            break_weight += weight_t(breaks) * problem.weight_list[c];
+        }
+    }
+}
+
+// lane_pick_var - WalkSAT (SKC) in lane l: in a picked unsat clause a var breaking nothing, otherwise with
+// random_flip_prob a random var, otherwise the var breaking the least, 0 if the clause is empty
+var_t lane_pick_var(const problem& problem, multiwalk& walk, uint64_t l, double random_flip_prob) {
+    clause_view clause = get_clause(problem, lane_pick_clause(problem, walk, l));
+    if (clause.size() == 0) {
+        return 0;
+    }
+    var_t flip_var = 0;
+    uint64_t best_hard = std::numeric_limits<uint64_t>::max();
+    weight_t best_weight = std::numeric_limits<weight_t>::max();
+    for (lit_t lit : clause) {
+        uint64_t break_hard;
+        weight_t break_weight;
+        lane_break(problem, walk, l, abs(lit), break_hard, break_weight);
+        if (break_hard == 0 and break_weight == 0) {
+            return abs(lit);
+        }
+        if (break_hard < best_hard or (break_hard == best_hard and break_weight < best_weight)) {
+            best_hard = break_hard;
+            best_weight = break_weight;
+            flip_var = abs(lit);
+        }
+    }
+    lane_state& lane = walk.lane_list[l];
+    if (walk.dist_float01(lane.engine) < random_flip_prob) {
+        return abs(clause[uint64_t(walk.dist_float01(lane.engine) * clause.size())]);
+    }
+    return flip_var;
+}
+
+// flip_lanes - flip every var of flip_list in the lanes of its flip_mask, then update the clauses they occur in
+WALKSAT_MULTIVERSION void flip_lanes(const problem& problem, multiwalk& walk) {
+    for (var_t var : walk.flip_list) {
+        walk.value_list[var] ^= walk.flip_mask[var];
+    }
+    for (var_t var : walk.flip_list) {
+        for (uint64_t k=0; k < 2; k++) {
+            lit_t lit = k == 0 ? lit_t(var) : -lit_t(var);
+            for (uint64_t c : get_occur(problem, lit)) {
+                update_clause(problem, walk, c);
+            }
+        }
+        walk.flip_mask[var] = 0;
+    }
+    walk.flip_list.clear();
+}
+
+// lane_done - lane meets the target, or has nothing left to repair
+bool lane_done(const lane_state& lane, weight_t target_weight) {
+    return lane.cost_hard == 0 and (lane.cost_weight <= target_weight or lane.num_unsat_soft == 0);
+}
+
+// get_lane_assignment - values of every var in lane l
+void get_lane_assignment(const multiwalk& walk, uint64_t l, assign_t& assignment) {
+    assignment.resize(walk.value_list.size());
+    assignment[0] = 0;
+    for (var_t var=1; var < walk.value_list.size(); var++) {
+        assignment[var] = walk.value_list[var] >> l & 1 ? +1 : -1;
+    }
+}
+
+assign_t multiwalk_search_problem(const problem& problem, const walksat_config& config, weight_t target_weight, steady_clock::time_point deadline, walksat_stats& stats, const component_search* search) {
+    // a clause is listed at most once per lane, so the unsat lists of a lane never outgrow the clauses of their kind
+    uint64_t num_soft_clauses = problem.num_clauses - problem.num_hard_clauses;
+    arena pool;
+    init_arena(pool, arena_array_size<lane_mask>(problem.num_variables + 1) * 2 + arena_array_size<clause_lanes>(problem.num_clauses)
+        + arena_array_size<var_t>(MULTIWALK_LANES)
+        + MULTIWALK_LANES * (arena_array_size<uint64_t>(problem.num_hard_clauses) + arena_array_size<uint64_t>(num_soft_clauses)),
+        config.huge_pages != 0);
+    multiwalk walk;
+    walk.value_list = arena_vector<lane_mask>(problem.num_variables + 1, 0, arena_allocator<lane_mask>(&pool));
+    walk.clause_list = arena_vector<clause_lanes>(problem.num_clauses, clause_lanes(), arena_allocator<clause_lanes>(&pool));
+    walk.flip_mask = arena_vector<lane_mask>(problem.num_variables + 1, 0, arena_allocator<lane_mask>(&pool));
+    walk.flip_list = arena_vector<var_t>(arena_allocator<var_t>(&pool));
+    walk.flip_list.reserve(MULTIWALK_LANES);
+    walk.dist_float01 = std::uniform_real_distribution<double>(0, 1);
+    walk.lane_list.resize(MULTIWALK_LANES);
+
+    // every lane starts from its own random assignment, lane 0 from the initial assignment of search if it has one,
+    // clauses start sat and update_clause lists the unsat ones
+    bool initial = search != nullptr and not search->initial_assignment.empty();
+    for (uint64_t l=0; l < MULTIWALK_LANES; l++) {
+        lane_state& lane = walk.lane_list[l];
+        std::seed_seq seed{config.seed, l};
+        lane.engine.seed(seed);
+        lane.unsat_hard_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(&pool));
+        lane.unsat_soft_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(&pool));
+        lane.unsat_hard_list.reserve(problem.num_hard_clauses);
+        lane.unsat_soft_list.reserve(num_soft_clauses);
+        lane.cost_hard = 0;
+        lane.cost_weight = 0;
+        lane.num_unsat_soft = 0;
+        for (var_t var=1; var <= problem.num_variables; var++) {
+            if ((l == 0 and initial) ? search->initial_assignment[var] > 0 : walk.dist_float01(lane.engine) < 0.5) {
+                walk.value_list[var] |= lane_mask(1) << l;
+            }
+        }
+    }
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        update_clause(problem, walk, c);
+    }
+
+    uint64_t best_assignment_hard = std::numeric_limits<uint64_t>::max();
+    weight_t best_assignment_weight = std::numeric_limits<weight_t>::max();
+    assign_t best_assignment(problem.num_variables + 1);
+    uint64_t best_lane = 0;
+    for (uint64_t l=0; l < MULTIWALK_LANES; l++) {
+        const lane_state& lane = walk.lane_list[l];
+        if (lane.cost_hard < best_assignment_hard or (lane.cost_hard == best_assignment_hard and lane.cost_weight < best_assignment_weight)) {
+            best_assignment_hard = lane.cost_hard;
+            best_assignment_weight = lane.cost_weight;
+            best_lane = l;
+        }
+    }
+    get_lane_assignment(walk, best_lane, best_assignment);
+    if (search != nullptr) {
+        report_component_best(*search->target, search->component, best_assignment_hard, best_assignment_weight);
+    }
+    stats.initial_hard_cost = best_assignment_hard;
+    stats.initial_soft_cost = best_assignment_weight; // scaled back by c_walksat
+    stats.num_tabu_blocked = 0;
+    stats.num_promising_flips = 0;
+    stats.num_restarts = 0;
+
+    uint64_t num_flips = 0;
+    uint64_t step = 0;
+    steady_clock::time_point search_start = steady_clock::now();
+    uint64_t start_allocations = pool.num_allocations;
+    while (true) {
+        step++;
+
+        // the best lane of this step, if it improves on the best so far, a lane meeting the target ends the search
+        bool improved = false;
+        bool done = false;
+        for (uint64_t l=0; l < MULTIWALK_LANES and not done; l++) {
+            const lane_state& lane = walk.lane_list[l];
+            done = lane_done(lane, target_weight);
+            if (done or lane.cost_hard < best_assignment_hard or (lane.cost_hard == best_assignment_hard and lane.cost_weight < best_assignment_weight)) {
+                if (search != nullptr) {
+                    report_component_best(*search->target, search->component, lane.cost_hard, lane.cost_weight);
+                }
+                best_assignment_hard = lane.cost_hard;
+                best_assignment_weight = lane.cost_weight;
+                best_lane = l;
+                improved = true;
+            }
+        }
+        if (improved) {
+            get_lane_assignment(walk, best_lane, best_assignment);
+        }
+
+        bool timeout = not done and step % MULTIWALK_TIME_CHECK_PERIOD == 0 and (steady_clock::now() > deadline or (search != nullptr and search->target->reached));
+        if (done or timeout) {
+            stats.num_flips = num_flips;
+            stats.search_time_s = std::chrono::duration<double>(steady_clock::now() - search_start).count();
+            stats.num_search_allocations = pool.num_allocations - start_allocations;
+            stats.huge_page_bytes = search_huge_page_bytes(problem, pool);
+            return best_assignment;
+        }
+
+        // every lane with an unsat clause picks a var, then the vars are flipped together
+        for (uint64_t l=0; l < MULTIWALK_LANES; l++) {
+            const lane_state& lane = walk.lane_list[l];
+            if (lane.cost_hard == 0 and lane.num_unsat_soft == 0) {
+                continue;
+            }
+            var_t var = lane_pick_var(problem, walk, l, config.rand_var_prob);
+            if (var == 0) { // empty clause, nothing to flip
+                continue;
+            }
+            if (walk.flip_mask[var] == 0) {
+                walk.flip_list.push_back(var);
+            }
+            walk.flip_mask[var] |= lane_mask(1) << l;
+            num_flips++;
+        }
+        flip_lanes(problem, walk);
+    }
+}
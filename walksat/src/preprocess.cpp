@@ -0,0 +1,856 @@
+#include"preprocess.h"
+#include<algorithm>
+#include<chrono>
+#include<limits>
+
+using steady_clock = std::chrono::steady_clock;
+
+// preprocess_state - clause database being simplified, removed clauses stay in place
+struct preprocess_state {
+    std::vector<clause_t> clause_list;
+    std::vector<weight_t> weight_list;
+    std::vector<bool> hard_list;
+    std::vector<bool> clause_removed;
+    std::vector<std::vector<uint64_t>> occur_list; // clauses containing literal, removed clauses are skipped lazily
+    std::vector<uint64_t> lit_count; // live clauses containing literal, indexed by lit_index
+    assign_t assignment; // values fixed so far, 0 if free
+    std::vector<lit_t> unit_queue; // literals of hard unit clauses, not yet propagated
+    std::vector<var_t> touched_var_list; // vars that lost an occurrence, candidates for pure literals
+    std::vector<bool> var_touched;
+    uint64_t fixed_hard;
+    weight_t fixed_weight;
+    bool conflict; // the hard clauses are unsatisfiable
+    std::vector<elimination_step> elimination_stack;
+    steady_clock::time_point deadline; // every pass stops here
+    bool timeout; // a pass stopped at the deadline
+};
+
+const uint64_t PREPROCESS_CLOCK_PERIOD = 64; // clauses processed between clock reads
+
+// out_of_time - the time budget of preprocessing is used up, read the clock after every PREPROCESS_CLOCK_PERIOD
+// steps so that a pass always gets that many
+bool out_of_time(steady_clock::time_point deadline, uint64_t step) {
+    return (step + 1) % PREPROCESS_CLOCK_PERIOD == 0 and steady_clock::now() > deadline;
+}
+
+// out_of_time - same for the passes over state, the stop is recorded in state.timeout
+bool out_of_time(preprocess_state& state, uint64_t step) {
+    if (out_of_time(state.deadline, step)) {
+        state.timeout = true;
+        return true;
+    }
+    return false;
+}
+
+// touch_var - var lost an occurrence and may have become pure
+void touch_var(preprocess_state& state, var_t var) {
+    if (not state.var_touched[var]) {
+        state.var_touched[var] = true;
+        state.touched_var_list.push_back(var);
+    }
+}
+
+// remove_clause - clause is satisfied or no longer needed
+void remove_clause(preprocess_state& state, uint64_t c) {
+    state.clause_removed[c] = true;
+    for (lit_t lit : state.clause_list[c]) {
+        state.lit_count[lit_index(lit)]--;
+        touch_var(state, abs(lit));
+    }
+}
+
+// falsify_clause - every literal of clause is false, its cost is paid whatever the search does
+void falsify_clause(preprocess_state& state, uint64_t c) {
+    if (state.hard_list[c]) {
+        state.fixed_hard++;
+        state.conflict = true;
+    } else {
+        state.fixed_weight += state.weight_list[c];
+    }
+    remove_clause(state, c);
+}
+
+// strip_literal - remove false literal from clause, an emptied clause is falsified, a hard unit is queued
+void strip_literal(preprocess_state& state, uint64_t c, lit_t lit) {
+    clause_t& clause = state.clause_list[c];
+    clause.erase(std::find(clause.begin(), clause.end(), lit));
+    state.lit_count[lit_index(lit)]--;
+    touch_var(state, abs(lit));
+    std::vector<uint64_t>& occur = state.occur_list[lit_index(lit)];
+    std::vector<uint64_t>::iterator it = std::find(occur.begin(), occur.end(), c);
+    if (it != occur.end()) {
+        occur.erase(it);
+    }
+    if (clause.empty()) {
+        falsify_clause(state, c);
+    } else if (clause.size() == 1 and state.hard_list[c]) {
+        state.unit_queue.push_back(clause[0]);
+    }
+}
+
+// assign_literal - fix lit to true, remove the clauses it satisfies and strip -lit from the others
+void assign_literal(preprocess_state& state, lit_t lit) {
+    state.assignment[abs(lit)] = lit > 0 ? +1 : -1;
+    for (uint64_t c : state.occur_list[lit_index(lit)]) {
+        if (not state.clause_removed[c]) {
+            remove_clause(state, c);
+        }
+    }
+    state.occur_list[lit_index(lit)].clear();
+    std::vector<uint64_t> occur;
+    occur.swap(state.occur_list[lit_index(-lit)]);
+    for (uint64_t c : occur) {
+        if (not state.clause_removed[c]) {
+            strip_literal(state, c, -lit);
+        }
+    }
+}
+
+// less_lit - order literals by var, +var before -var
+bool less_lit(lit_t a, lit_t b) {
+    return lit_index(a) < lit_index(b);
+}
+
+// clause_hash - hash of the sorted literals and the kind of a clause
+uint64_t clause_hash(clause_view clause, bool hard) {
+    uint64_t hash = hard ? 1 : 0;
+    for (lit_t lit : clause) {
+        hash = (hash ^ uint64_t(lit)) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+// normalized_clauses - clauses of a problem with their literals sorted and without repeats, back to back like
+// problem.lit_list, tautologies and merged duplicates are removed in place
+struct normalized_clauses {
+    std::vector<lit_t> lit_list;
+    std::vector<uint64_t> clause_start;
+    std::vector<weight_t> weight_list;
+    std::vector<bool> hard_list;
+    std::vector<bool> clause_removed;
+};
+
+// get_normalized_clause -
+clause_view get_normalized_clause(const normalized_clauses& normalized, uint64_t c) {
+    clause_view clause;
+    clause.first = normalized.lit_list.data() + normalized.clause_start[c];
+    clause.last = normalized.lit_list.data() + normalized.clause_start[c + 1];
+    return clause;
+}
+
+// normalize_clauses - sort literals, drop repeated literals and tautologies, merge duplicate clauses of the same kind
+// summing their soft weights, the incremental sat counts of the search rely on every var occurring once per clause.
+// The literals are compacted in one flat copy of original.lit_list, no clause gets an allocation of its own.
+// Merging is the only step the search can do without, it stops at deadline
+void normalize_clauses(const problem& original, steady_clock::time_point deadline, normalized_clauses& normalized, walksat_stats& stats) {
+    stats.num_duplicate_literals = 0;
+    stats.num_tautologies = 0;
+    stats.num_duplicate_clauses = 0;
+    normalized.lit_list.assign(original.lit_list.begin(), original.lit_list.end());
+    normalized.clause_start.assign(original.num_clauses + 1, 0);
+    normalized.weight_list = original.weight_list;
+    normalized.hard_list = original.hard_list;
+    normalized.clause_removed.assign(original.num_clauses, false);
+    std::vector<std::pair<uint64_t, uint64_t>> hash_list; // hash and index of every clause that is not a tautology
+    uint64_t end = 0; // end of the compacted literals
+    for (uint64_t c=0; c < original.num_clauses; c++) {
+        lit_t* first = normalized.lit_list.data() + original.clause_start[c];
+        lit_t* last = normalized.lit_list.data() + original.clause_start[c + 1];
+        std::sort(first, last, less_lit);
+        last = std::unique(first, last);
+        stats.num_duplicate_literals += original.clause_start[c + 1] - original.clause_start[c] - (last - first);
+        normalized.clause_start[c] = end;
+        bool tautology = false;
+        for (uint64_t j=1; j < uint64_t(last - first); j++) {
+            if (first[j] == -first[j-1]) {
+                tautology = true;
+                break;
+            }
+        }
+        if (tautology) {
+            normalized.clause_removed[c] = true; // its literals are dropped, it keeps an empty range
+            stats.num_tautologies++;
+            continue;
+        }
+        clause_view clause;
+        clause.first = normalized.lit_list.data() + end;
+        clause.last = std::copy(first, last, normalized.lit_list.data() + end);
+        end = clause.last - normalized.lit_list.data();
+        hash_list.push_back(std::make_pair(clause_hash(clause, normalized.hard_list[c]), c));
+    }
+    normalized.clause_start[original.num_clauses] = end;
+    normalized.lit_list.resize(end);
+    // duplicates have equal hashes, sorting the hashes puts them in the same run, the first clause of a run is kept
+    std::sort(hash_list.begin(), hash_list.end());
+    for (uint64_t i=0, step=0; i < hash_list.size(); step++) {
+        if (out_of_time(deadline, step)) {
+            stats.preprocess_timeout = 1;
+            break;
+        }
+        uint64_t run_end = i + 1;
+        while (run_end < hash_list.size() and hash_list[run_end].first == hash_list[i].first) {
+            run_end++;
+        }
+        for (uint64_t a=i; a < run_end; a++) {
+            uint64_t kept = hash_list[a].second;
+            if (normalized.clause_removed[kept]) {
+                continue;
+            }
+            clause_view kept_clause = get_normalized_clause(normalized, kept);
+            for (uint64_t b=a+1; b < run_end; b++) {
+                uint64_t c = hash_list[b].second;
+                clause_view clause = get_normalized_clause(normalized, c);
+                if (not normalized.clause_removed[c] and normalized.hard_list[c] == normalized.hard_list[kept]
+                    and clause.size() == kept_clause.size() and std::equal(clause.begin(), clause.end(), kept_clause.begin())) {
+                    normalized.weight_list[kept] += normalized.weight_list[c];
+                    normalized.clause_removed[c] = true;
+                    stats.num_duplicate_clauses++;
+                }
+            }
+        }
+        i = run_end;
+    }
+}
+
+// make_preprocess_state - copy of the normalized clauses with their occurrences, false if state.deadline passed
+// before the copy was done
+bool make_preprocess_state(const normalized_clauses& normalized, uint64_t num_variables, preprocess_state& state) {
+    uint64_t num_clauses = normalized.weight_list.size();
+    state.clause_list.assign(num_clauses, clause_t());
+    for (uint64_t c=0; c < num_clauses; c++) {
+        if (out_of_time(state, c)) {
+            return false;
+        }
+        if (not normalized.clause_removed[c]) {
+            clause_view clause = get_normalized_clause(normalized, c);
+            state.clause_list[c].assign(clause.begin(), clause.end());
+        }
+    }
+    state.weight_list = normalized.weight_list;
+    state.hard_list = normalized.hard_list;
+    state.clause_removed = normalized.clause_removed;
+    state.occur_list.assign(2 * (num_variables + 1), std::vector<uint64_t>());
+    state.lit_count.assign(2 * (num_variables + 1), 0);
+    state.assignment.assign(num_variables + 1, 0);
+    state.var_touched.assign(num_variables + 1, false);
+    state.fixed_hard = 0;
+    state.fixed_weight = 0;
+    state.conflict = false;
+    state.elimination_stack.clear();
+    // count first so that every occurrence list is allocated once
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (not state.clause_removed[c]) {
+            for (lit_t lit : state.clause_list[c]) {
+                state.lit_count[lit_index(lit)]++;
+            }
+        }
+    }
+    for (uint64_t i=0; i < state.occur_list.size(); i++) {
+        if (out_of_time(state, i)) {
+            return false;
+        }
+        state.occur_list[i].reserve(state.lit_count[i]);
+    }
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (out_of_time(state, c)) {
+            return false;
+        }
+        if (state.clause_removed[c]) {
+            continue;
+        }
+        for (lit_t lit : state.clause_list[c]) {
+            state.occur_list[lit_index(lit)].push_back(c);
+        }
+        if (state.clause_list[c].empty()) {
+            falsify_clause(state, c);
+        } else if (state.clause_list[c].size() == 1 and state.hard_list[c]) {
+            state.unit_queue.push_back(state.clause_list[c][0]);
+        }
+    }
+    return true;
+}
+
+// propagate_units - assign the literals of hard unit clauses until none is left,
+// a unit conflicting with an earlier one has already been emptied and falsified
+uint64_t propagate_units(preprocess_state& state) {
+    uint64_t num_units = 0;
+    for (uint64_t step=0; not state.unit_queue.empty(); step++) {
+        if (out_of_time(state, step)) {
+            break; // the units left stay in the problem as clauses
+        }
+        lit_t lit = state.unit_queue.back();
+        state.unit_queue.pop_back();
+        if (state.assignment[abs(lit)] == 0) {
+            assign_literal(state, lit);
+            num_units++;
+        }
+    }
+    return num_units;
+}
+
+// eliminate_pure_literals - a literal whose negation occurs in no clause is set true, this never costs anything
+uint64_t eliminate_pure_literals(preprocess_state& state) {
+    uint64_t num_pures = 0;
+    for (var_t var=1; var < state.assignment.size(); var++) {
+        touch_var(state, var);
+    }
+    for (uint64_t step=0; not state.touched_var_list.empty(); step++) {
+        if (out_of_time(state, step)) {
+            break;
+        }
+        var_t var = state.touched_var_list.back();
+        state.touched_var_list.pop_back();
+        state.var_touched[var] = false;
+        if (state.assignment[var] != 0) {
+            continue;
+        }
+        uint64_t pos_count = state.lit_count[lit_index(+lit_t(var))];
+        uint64_t neg_count = state.lit_count[lit_index(-lit_t(var))];
+        if (pos_count > 0 and neg_count == 0) {
+            assign_literal(state, +lit_t(var));
+            num_pures++;
+        } else if (neg_count > 0 and pos_count == 0) {
+            assign_literal(state, -lit_t(var));
+            num_pures++;
+        }
+    }
+    return num_pures;
+}
+
+// clause_signature - bloom filter of the vars of clause, a clause can only subsume or strengthen
+// another clause if its signature is contained in the signature of the other
+uint64_t clause_signature(const clause_t& clause) {
+    uint64_t sig = 0;
+    for (lit_t lit : clause) {
+        sig |= uint64_t(1) << (uint64_t(abs(lit)) % 64);
+    }
+    return sig;
+}
+
+// subsume_check - every literal of a is in b (flipped is 0), or all but one which is negated in b (flipped is that
+// literal of b, resolving a and b gives b without it), literals are sorted by var
+bool subsume_check(const clause_t& a, const clause_t& b, lit_t& flipped) {
+    flipped = 0;
+    uint64_t j = 0;
+    for (lit_t lit : a) {
+        while (j < b.size() and abs(b[j]) < abs(lit)) {
+            j++;
+        }
+        if (j == b.size() or abs(b[j]) != abs(lit)) {
+            return false;
+        }
+        if (b[j] != lit) {
+            if (flipped != 0) {
+                return false;
+            }
+            flipped = b[j];
+        }
+        j++;
+    }
+    return true;
+}
+
+// subsume_clauses - remove hard clauses subsumed by a hard clause and strengthen hard clauses by self-subsuming
+// resolution, shortest clauses first. Soft clauses are left alone: dropping or shortening one is only exact for
+// assignments that satisfy the hard clause it depends on
+void subsume_clauses(preprocess_state& state, walksat_stats& stats) {
+    std::vector<uint64_t> sig(state.clause_list.size(), 0);
+    std::vector<bool> queued(state.clause_list.size(), false);
+    std::vector<uint64_t> queue;
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (not state.clause_removed[c] and state.hard_list[c]) {
+            sig[c] = clause_signature(state.clause_list[c]);
+            queued[c] = true;
+            queue.push_back(c);
+        }
+    }
+    std::stable_sort(queue.begin(), queue.end(), [&state](uint64_t a, uint64_t b) {
+        return state.clause_list[a].size() < state.clause_list[b].size();
+    });
+    std::vector<uint64_t> candidate_list;
+    for (uint64_t i=0; i < queue.size(); i++) {
+        if (out_of_time(state, i)) {
+            break;
+        }
+        uint64_t c = queue[i];
+        queued[c] = false;
+        if (state.clause_removed[c]) {
+            continue;
+        }
+        // every clause subsumed or strengthened by c contains its least occurring var
+        var_t best_var = 0;
+        uint64_t best_count = std::numeric_limits<uint64_t>::max();
+        for (lit_t lit : state.clause_list[c]) {
+            uint64_t count = state.lit_count[lit_index(lit)] + state.lit_count[lit_index(-lit)];
+            if (count < best_count) {
+                best_var = abs(lit);
+                best_count = count;
+            }
+        }
+        candidate_list = state.occur_list[lit_index(+lit_t(best_var))];
+        const std::vector<uint64_t>& neg_occur = state.occur_list[lit_index(-lit_t(best_var))];
+        candidate_list.insert(candidate_list.end(), neg_occur.begin(), neg_occur.end());
+        for (uint64_t d : candidate_list) {
+            if (d == c or state.clause_removed[d] or not state.hard_list[d]) {
+                continue;
+            }
+            if (state.clause_list[d].size() < state.clause_list[c].size() or (sig[c] & ~sig[d]) != 0) {
+                continue;
+            }
+            lit_t flipped;
+            if (not subsume_check(state.clause_list[c], state.clause_list[d], flipped)) {
+                continue;
+            }
+            if (flipped == 0) {
+                remove_clause(state, d);
+                stats.num_subsumed_clauses++;
+                continue;
+            }
+            strip_literal(state, d, flipped);
+            stats.num_strengthened_literals++;
+            if (not state.clause_removed[d]) {
+                sig[d] = clause_signature(state.clause_list[d]);
+                if (not queued[d]) {
+                    queued[d] = true;
+                    queue.push_back(d);
+                }
+            }
+        }
+    }
+}
+
+// add_clause - append a new live clause with sorted literals, an empty clause is falsified, a hard unit is queued
+void add_clause(preprocess_state& state, const clause_t& clause, weight_t weight, bool hard) {
+    uint64_t c = state.clause_list.size();
+    state.clause_list.push_back(clause);
+    state.weight_list.push_back(weight);
+    state.hard_list.push_back(hard);
+    state.clause_removed.push_back(false);
+    for (lit_t lit : clause) {
+        state.occur_list[lit_index(lit)].push_back(c);
+        state.lit_count[lit_index(lit)]++;
+    }
+    if (clause.empty()) {
+        falsify_clause(state, c);
+    } else if (clause.size() == 1 and hard) {
+        state.unit_queue.push_back(clause[0]);
+    }
+}
+
+// substitute_var - replace var by lit in every clause, a clause that already contains lit loses var,
+// one that contains -lit becomes a tautology and is removed
+void substitute_var(preprocess_state& state, var_t var, lit_t lit) {
+    for (lit_t old_lit : {+lit_t(var), -lit_t(var)}) {
+        lit_t new_lit = old_lit > 0 ? lit : -lit;
+        std::vector<uint64_t> occur;
+        occur.swap(state.occur_list[lit_index(old_lit)]);
+        for (uint64_t c : occur) {
+            if (state.clause_removed[c]) {
+                continue;
+            }
+            clause_t& clause = state.clause_list[c];
+            if (std::find(clause.begin(), clause.end(), -new_lit) != clause.end()) {
+                remove_clause(state, c);
+            } else if (std::find(clause.begin(), clause.end(), new_lit) != clause.end()) {
+                strip_literal(state, c, old_lit);
+            } else {
+                *std::find(clause.begin(), clause.end(), old_lit) = new_lit;
+                std::sort(clause.begin(), clause.end(), less_lit);
+                state.lit_count[lit_index(old_lit)]--;
+                state.lit_count[lit_index(new_lit)]++;
+                state.occur_list[lit_index(new_lit)].push_back(c);
+            }
+        }
+    }
+}
+
+// substitute_equivalences - literals on a cycle of the implication graph of the hard binary clauses are
+// equivalent, every var of a strongly connected component is replaced by the literal of its smallest var
+uint64_t substitute_equivalences(preprocess_state& state) {
+    uint64_t num_variables = state.assignment.size() - 1;
+    uint64_t num_nodes = 2 * (num_variables + 1);
+    std::vector<std::vector<uint64_t>> edge_list(num_nodes); // -a implies b and -b implies a for clause a or b
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (out_of_time(state, c)) {
+            return 0;
+        }
+        const clause_t& clause = state.clause_list[c];
+        if (not state.clause_removed[c] and state.hard_list[c] and clause.size() == 2) {
+            edge_list[lit_index(-clause[0])].push_back(lit_index(clause[1]));
+            edge_list[lit_index(-clause[1])].push_back(lit_index(clause[0]));
+        }
+    }
+    // tarjan with an explicit stack of (node, next edge)
+    const uint64_t unvisited = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> index(num_nodes, unvisited);
+    std::vector<uint64_t> low(num_nodes, 0);
+    std::vector<bool> on_stack(num_nodes, false);
+    std::vector<uint64_t> component(num_nodes, unvisited);
+    std::vector<lit_t> component_lit; // literal of the smallest var of each component
+    std::vector<uint64_t> scc_stack;
+    std::vector<std::pair<uint64_t, uint64_t>> call_stack;
+    uint64_t next_index = 0;
+    for (uint64_t root=2; root < num_nodes; root++) {
+        if (out_of_time(state, root)) {
+            return 0; // a component cut short could be merged with a literal it is not equivalent to
+        }
+        if (index[root] != unvisited or edge_list[root].empty()) {
+            continue;
+        }
+        call_stack.push_back(std::make_pair(root, 0));
+        while (not call_stack.empty()) {
+            uint64_t node = call_stack.back().first;
+            uint64_t& edge = call_stack.back().second;
+            if (edge == 0 and index[node] == unvisited) {
+                index[node] = low[node] = next_index++;
+                scc_stack.push_back(node);
+                on_stack[node] = true;
+            }
+            if (edge < edge_list[node].size()) {
+                uint64_t next = edge_list[node][edge++];
+                if (index[next] == unvisited) {
+                    call_stack.push_back(std::make_pair(next, 0));
+                } else if (on_stack[next]) {
+                    low[node] = std::min(low[node], index[next]);
+                }
+                continue;
+            }
+            if (low[node] == index[node]) {
+                lit_t rep = 0;
+                uint64_t id = component_lit.size();
+                while (true) {
+                    uint64_t member = scc_stack.back();
+                    scc_stack.pop_back();
+                    on_stack[member] = false;
+                    component[member] = id;
+                    lit_t lit = member % 2 == 0 ? lit_t(member / 2) : -lit_t(member / 2);
+                    if (rep == 0 or abs(lit) < abs(rep)) {
+                        rep = lit;
+                    }
+                    if (member == node) {
+                        break;
+                    }
+                }
+                component_lit.push_back(rep);
+            }
+            call_stack.pop_back();
+            if (not call_stack.empty()) {
+                uint64_t parent = call_stack.back().first;
+                low[parent] = std::min(low[parent], low[node]);
+            }
+        }
+    }
+    uint64_t num_equivalent = 0;
+    for (var_t var=1; var <= num_variables; var++) {
+        if (out_of_time(state, var)) {
+            break; // every substitution made is exact on its own
+        }
+        uint64_t id = component[lit_index(+lit_t(var))];
+        if (state.assignment[var] != 0 or id == unvisited) {
+            continue;
+        }
+        if (id == component[lit_index(-lit_t(var))]) { // var is equivalent to -var
+            state.conflict = true;
+            return num_equivalent;
+        }
+        lit_t rep = component_lit[id];
+        if (var_t(abs(rep)) == var) {
+            continue;
+        }
+        substitute_var(state, var, rep);
+        elimination_step step;
+        step.var = var;
+        step.equal_lit = rep;
+        state.elimination_stack.push_back(step);
+        num_equivalent++;
+    }
+    return num_equivalent;
+}
+
+const uint64_t BVE_MAX_OCCURRENCES = 16; // vars occurring in more clauses are not eliminated
+const uint64_t BVE_MAX_RESOLVENT_SIZE = 16;
+
+// resolve - resolvent of a and b on var, false if it is a tautology, literals are sorted by var
+bool resolve(const clause_t& a, const clause_t& b, var_t var, clause_t& resolvent) {
+    resolvent.clear();
+    uint64_t i = 0;
+    uint64_t j = 0;
+    while (i < a.size() or j < b.size()) {
+        lit_t lit;
+        if (j == b.size() or (i < a.size() and abs(a[i]) < abs(b[j]))) {
+            lit = a[i++];
+        } else if (i == a.size() or abs(b[j]) < abs(a[i])) {
+            lit = b[j++];
+        } else {
+            if (a[i] != b[j] and var_t(abs(a[i])) != var) {
+                return false;
+            }
+            lit = a[i++];
+            j++;
+        }
+        if (var_t(abs(lit)) != var) {
+            resolvent.push_back(lit);
+        }
+    }
+    return true;
+}
+
+// eliminate_vars - replace the clauses of a var by all their resolvents on it if that does not add clauses,
+// only vars occurring in hard clauses alone so that every soft clause keeps its cost, fewest occurrences first
+uint64_t eliminate_vars(preprocess_state& state) {
+    uint64_t num_variables = state.assignment.size() - 1;
+    std::vector<var_t> var_list;
+    for (var_t var=1; var <= num_variables; var++) {
+        uint64_t count = state.lit_count[lit_index(+lit_t(var))] + state.lit_count[lit_index(-lit_t(var))];
+        if (state.assignment[var] == 0 and count > 0 and count <= BVE_MAX_OCCURRENCES) {
+            var_list.push_back(var);
+        }
+    }
+    std::stable_sort(var_list.begin(), var_list.end(), [&state](var_t a, var_t b) {
+        return state.lit_count[lit_index(+lit_t(a))] + state.lit_count[lit_index(-lit_t(a))]
+            < state.lit_count[lit_index(+lit_t(b))] + state.lit_count[lit_index(-lit_t(b))];
+    });
+    uint64_t num_eliminated = 0;
+    std::vector<uint64_t> pos_list;
+    std::vector<uint64_t> neg_list;
+    std::vector<clause_t> resolvent_list;
+    clause_t resolvent;
+    for (uint64_t i=0; i < var_list.size(); i++) {
+        if (out_of_time(state, i)) {
+            break;
+        }
+        var_t var = var_list[i];
+        if (state.assignment[var] != 0) {
+            continue;
+        }
+        bool eligible = true;
+        pos_list.clear();
+        neg_list.clear();
+        for (lit_t lit : {+lit_t(var), -lit_t(var)}) {
+            for (uint64_t c : state.occur_list[lit_index(lit)]) {
+                if (state.clause_removed[c]) {
+                    continue;
+                }
+                // a hard unit is about to be propagated
+                eligible = eligible and state.hard_list[c] and state.clause_list[c].size() > 1;
+                (lit > 0 ? pos_list : neg_list).push_back(c);
+            }
+        }
+        if (not eligible or pos_list.size() + neg_list.size() > BVE_MAX_OCCURRENCES) {
+            continue;
+        }
+        resolvent_list.clear();
+        for (uint64_t p : pos_list) {
+            for (uint64_t n : neg_list) {
+                if (resolve(state.clause_list[p], state.clause_list[n], var, resolvent)) {
+                    resolvent_list.push_back(resolvent);
+                    eligible = eligible and resolvent.size() <= BVE_MAX_RESOLVENT_SIZE;
+                }
+            }
+            if (not eligible or resolvent_list.size() > pos_list.size() + neg_list.size()) {
+                break;
+            }
+        }
+        if (not eligible or resolvent_list.size() > pos_list.size() + neg_list.size()) {
+            continue;
+        }
+        elimination_step step;
+        step.var = var;
+        step.equal_lit = 0;
+        for (uint64_t c : pos_list) {
+            step.clause_list.push_back(state.clause_list[c]);
+            remove_clause(state, c);
+        }
+        for (uint64_t c : neg_list) {
+            step.clause_list.push_back(state.clause_list[c]);
+            remove_clause(state, c);
+        }
+        state.occur_list[lit_index(+lit_t(var))].clear();
+        state.occur_list[lit_index(-lit_t(var))].clear();
+        state.elimination_stack.push_back(step);
+        for (const clause_t& clause : resolvent_list) {
+            add_clause(state, clause, 0, true);
+        }
+        num_eliminated++;
+    }
+    return num_eliminated;
+}
+
+// make_reduced_problem - renumber the free vars that still occur and keep the live clauses
+void make_reduced_problem(const preprocess_state& state, problem& reduced, preprocess_map& map, bool huge_pages) {
+    uint64_t num_variables = state.assignment.size() - 1;
+    std::vector<var_t> reduced_var(num_variables + 1, 0);
+    map.num_variables = num_variables;
+    map.var_list.assign(1, 0);
+    map.fixed_assignment = state.assignment;
+    map.fixed_hard = state.fixed_hard;
+    map.fixed_weight = state.fixed_weight;
+    map.elimination_stack = state.elimination_stack;
+    for (var_t var=1; var <= num_variables; var++) {
+        if (state.assignment[var] == 0 and state.lit_count[lit_index(+lit_t(var))] + state.lit_count[lit_index(-lit_t(var))] > 0) {
+            reduced_var[var] = map.var_list.size();
+            map.var_list.push_back(var);
+        }
+    }
+    uint64_t num_clauses = 0;
+    uint64_t num_literals = 0;
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (not state.clause_removed[c]) {
+            num_clauses++;
+            num_literals += state.clause_list[c].size();
+        }
+    }
+    init_problem(reduced, map.var_list.size() - 1, num_clauses, num_literals, huge_pages);
+    clause_t clause;
+    for (uint64_t c=0; c < state.clause_list.size(); c++) {
+        if (state.clause_removed[c]) {
+            continue;
+        }
+        clause.clear();
+        for (lit_t lit : state.clause_list[c]) {
+            lit_t var = lit_t(reduced_var[abs(lit)]);
+            clause.push_back(lit > 0 ? var : -var);
+        }
+        push_clause(reduced, clause.data(), clause.data() + clause.size(), state.weight_list[c], state.hard_list[c]);
+    }
+}
+
+// make_normalized_problem - the normalized clauses as they are with the vars that occur renumbered, empty clauses
+// are paid for up front like falsify_clause does
+void make_normalized_problem(const normalized_clauses& normalized, uint64_t num_variables, problem& reduced, preprocess_map& map, bool huge_pages) {
+    std::vector<var_t> reduced_var(num_variables + 1, 0);
+    map.num_variables = num_variables;
+    map.var_list.assign(1, 0);
+    map.fixed_assignment.assign(num_variables + 1, 0);
+    map.fixed_hard = 0;
+    map.fixed_weight = 0;
+    map.elimination_stack.clear();
+    uint64_t num_clauses = 0;
+    uint64_t num_literals = 0;
+    for (uint64_t c=0; c < normalized.weight_list.size(); c++) {
+        clause_view clause = get_normalized_clause(normalized, c);
+        if (normalized.clause_removed[c]) {
+            continue;
+        }
+        if (clause.size() == 0) {
+            if (normalized.hard_list[c]) {
+                map.fixed_hard++;
+            } else {
+                map.fixed_weight += normalized.weight_list[c];
+            }
+            continue;
+        }
+        num_clauses++;
+        num_literals += clause.size();
+        for (lit_t lit : clause) {
+            reduced_var[abs(lit)] = 1;
+        }
+    }
+    for (var_t var=1; var <= num_variables; var++) {
+        if (reduced_var[var] != 0) {
+            reduced_var[var] = map.var_list.size();
+            map.var_list.push_back(var);
+        }
+    }
+    init_problem(reduced, map.var_list.size() - 1, num_clauses, num_literals, huge_pages);
+    clause_t reduced_clause;
+    for (uint64_t c=0; c < normalized.weight_list.size(); c++) {
+        clause_view clause = get_normalized_clause(normalized, c);
+        if (normalized.clause_removed[c] or clause.size() == 0) {
+            continue;
+        }
+        reduced_clause.clear();
+        for (lit_t lit : clause) {
+            lit_t var = lit_t(reduced_var[abs(lit)]);
+            reduced_clause.push_back(lit > 0 ? var : -var);
+        }
+        push_clause(reduced, reduced_clause.data(), reduced_clause.data() + reduced_clause.size(), normalized.weight_list[c], normalized.hard_list[c]);
+    }
+}
+
+void preprocess_problem(const problem& original, const walksat_config& config, steady_clock::time_point deadline, problem& reduced, preprocess_map& map, walksat_stats& stats) {
+    normalized_clauses normalized;
+    stats.preprocess_timeout = 0;
+    normalize_clauses(original, deadline, normalized, stats);
+    stats.num_unit_vars = 0;
+    stats.num_pure_vars = 0;
+    stats.num_subsumed_clauses = 0;
+    stats.num_strengthened_literals = 0;
+    stats.num_equivalent_vars = 0;
+    stats.num_eliminated_vars = 0;
+    stats.preprocess_conflict = 0;
+    bool simplified = false;
+    if (config.preprocess != 0) {
+        preprocess_state state;
+        state.deadline = deadline;
+        state.timeout = false;
+        // an incomplete copy is dropped and the normalized problem is searched
+        bool made = make_preprocess_state(normalized, original.num_variables, state);
+        state.conflict = false; // empty hard clauses of the input are not derived by preprocessing
+        if (made) {
+            stats.num_unit_vars += propagate_units(state);
+            subsume_clauses(state, stats);
+            stats.num_unit_vars += propagate_units(state);
+            stats.num_equivalent_vars += substitute_equivalences(state);
+            stats.num_unit_vars += propagate_units(state);
+            stats.num_eliminated_vars += eliminate_vars(state);
+            stats.num_unit_vars += propagate_units(state);
+            stats.num_pure_vars += eliminate_pure_literals(state);
+        }
+        if (state.timeout) {
+            stats.preprocess_timeout = 1;
+        }
+        if (state.conflict) {
+            // the hard clauses are unsatisfiable, the simplifications only keep their models and
+            // would fix vars to values that violate many hard clauses, search the normalized problem instead
+            stats.preprocess_conflict = 1;
+            stats.num_unit_vars = 0;
+            stats.num_pure_vars = 0;
+            stats.num_subsumed_clauses = 0;
+            stats.num_strengthened_literals = 0;
+            stats.num_equivalent_vars = 0;
+            stats.num_eliminated_vars = 0;
+        } else if (made) {
+            make_reduced_problem(state, reduced, map, original.huge_pages);
+            simplified = true;
+        }
+    }
+    if (not simplified) {
+        make_normalized_problem(normalized, original.num_variables, reduced, map, original.huge_pages);
+    }
+    stats.num_reduced_variables = reduced.num_variables;
+    stats.num_reduced_clauses = reduced.num_clauses;
+}
+
+void reconstruct_assignment(const preprocess_map& map, const assign_t& reduced_assignment, assign_t& assignment) {
+    assignment.assign(map.num_variables + 1, +1); // vars left in no clause can take any value
+    assignment[0] = 0;
+    for (var_t var=1; var <= map.num_variables; var++) {
+        if (map.fixed_assignment[var] != 0) {
+            assignment[var] = map.fixed_assignment[var];
+        }
+    }
+    for (var_t var=1; var < map.var_list.size(); var++) {
+        assignment[map.var_list[var]] = reduced_assignment[var];
+    }
+    for (uint64_t i=map.elimination_stack.size(); i > 0; i--) {
+        const elimination_step& step = map.elimination_stack[i-1];
+        if (step.equal_lit != 0) {
+            assignment[step.var] = step.equal_lit > 0 ? assignment[step.equal_lit] : -assignment[-step.equal_lit];
+            continue;
+        }
+        // false unless a clause with +var is not satisfied otherwise, the resolvents then satisfy those with -var
+        assignment[step.var] = -1;
+        for (const clause_t& clause : step.clause_list) {
+            bool sat = false;
+            for (lit_t lit : clause) {
+                sat = sat or lit * assignment[abs(lit)] > 0;
+            }
+            if (not sat) {
+                assignment[step.var] = +1;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include"reorder.h"
+#include<algorithm>
+#include<cstdlib>
+
+void reorder_problem(const problem& problem, struct problem& reordered, std::vector<var_t>& var_list) {
+    // clauses of every var (CSR), var has var_clause_list from var_clause_start[var] up to var_clause_start[var+1]
+    std::vector<uint64_t> var_clause_start(problem.num_variables + 2, 0);
+    for (lit_t lit : problem.lit_list) {
+        var_clause_start[abs(lit) + 1]++;
+    }
+    for (var_t var=0; var <= problem.num_variables; var++) {
+        var_clause_start[var + 1] += var_clause_start[var];
+    }
+    std::vector<uint64_t> var_clause_list(problem.lit_list.size());
+    std::vector<uint64_t> var_clause_end(var_clause_start.begin(), var_clause_start.end() - 1);
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        for (lit_t lit : get_clause(problem, c)) {
+            var_clause_list[var_clause_end[abs(lit)]++] = c;
+        }
+    }
+    auto degree = [&var_clause_start](var_t var) -> uint64_t {
+        return var_clause_start[var + 1] - var_clause_start[var];
+    };
+    std::vector<var_t> by_degree(problem.num_variables);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        by_degree[var-1] = var;
+    }
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](var_t a, var_t b) {
+        return degree(a) < degree(b);
+    });
+
+    // breadth first from a var of least degree, the vars first reached from the same var are taken by degree
+    std::vector<var_t> new_var(problem.num_variables + 1, 0);
+    std::vector<bool> clause_reached(problem.num_clauses, false);
+    std::vector<uint64_t> clause_order;
+    var_list.assign(1, 0);
+    std::vector<var_t> reached;
+    for (var_t start : by_degree) {
+        if (new_var[start] != 0) {
+            continue;
+        }
+        new_var[start] = var_list.size();
+        var_list.push_back(start);
+        for (uint64_t head=var_list.size()-1; head < var_list.size(); head++) {
+            reached.clear();
+            for (uint64_t k=var_clause_start[var_list[head]]; k < var_clause_start[var_list[head] + 1]; k++) {
+                uint64_t c = var_clause_list[k];
+                if (clause_reached[c]) {
+                    continue;
+                }
+                clause_reached[c] = true;
+                clause_order.push_back(c);
+                for (lit_t lit : get_clause(problem, c)) {
+                    var_t var = abs(lit);
+                    if (new_var[var] == 0) {
+                        new_var[var] = problem.num_variables + 1; // reached, numbered below
+                        reached.push_back(var);
+                    }
+                }
+            }
+            std::stable_sort(reached.begin(), reached.end(), [&degree](var_t a, var_t b) {
+                return degree(a) < degree(b);
+            });
+            for (var_t var : reached) {
+                new_var[var] = var_list.size();
+                var_list.push_back(var);
+            }
+        }
+    }
+
+    init_problem(reordered, problem.num_variables, problem.num_clauses, problem.lit_list.size(), problem.huge_pages);
+    clause_t clause;
+    for (uint64_t c : clause_order) {
+        clause.clear();
+        for (lit_t lit : get_clause(problem, c)) {
+            lit_t var = lit_t(new_var[abs(lit)]);
+            clause.push_back(lit > 0 ? var : -var);
+        }
+        push_clause(reordered, clause.data(), clause.data() + clause.size(), problem.weight_list[c], problem.hard_list[c]);
+    }
+}
@@ -1,30 +1,68 @@
 #include"walksat.h"
+#include"problem.h"
+#include"preprocess.h"
+#include"component.h"
+#include"reorder.h"
+#include"arena.h"
+#include"eval.h"
+#include"multiwalk.h"
+#include"cpu.h"
 #include<vector>
-#include<ctime>
+#include<algorithm>
+#include<chrono>
 #include<random>
 #include<limits>
+#include<cmath>
 #include<functional>
-#include<iostream>
+#include<thread>
+#include<atomic>
 
 using rand_t = std::function<double()>;
+using steady_clock = std::chrono::steady_clock;
 
-template<typename T> void copy_vector(std::vector<T>& target, const std::vector<T>& source) {
-    target.clear();
-    for (uint64_t i=0; i< source.size(); i++) {
-        target.push_back(source[i]);
+// WALKSAT_PREFETCH_DISTANCE - occurrence list entries a flip looks ahead to prefetch the state of their
+// clauses, 0 disables prefetching, set at compile time with -DWALKSAT_PREFETCH_DISTANCE=n
+#ifndef WALKSAT_PREFETCH_DISTANCE
+#define WALKSAT_PREFETCH_DISTANCE 4
+#endif
+const uint64_t PREFETCH_DISTANCE = WALKSAT_PREFETCH_DISTANCE;
+
+// prefetch - hint that the cache line of p is used soon, nothing where the compiler has no hint
+inline void prefetch(const void* p) {
+#if WALKSAT_PREFETCH_DISTANCE > 0 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_prefetch(p, 1, 3);
+#else
+    (void)p;
+#endif
+}
+
+// prefetch_ahead - prefetch the state of entry i + PREFETCH_DISTANCE of list if there is one
+template<typename T, typename F> inline void prefetch_ahead(list_view<T> list, uint64_t i, F address) {
+    if (PREFETCH_DISTANCE > 0 and i + PREFETCH_DISTANCE < list.size()) {
+        prefetch(address(list[i + PREFETCH_DISTANCE]));
     }
 }
 
-uint64_t weighted_random(const std::vector<double>& dist, double v) {
-    double sum_weight = 0;
+uint64_t walksat_prefetch_distance() {
+    return PREFETCH_DISTANCE;
+}
+
+uint64_t weighted_random(const arena_vector<weight_t>& dist, double v) {
+    weight_t sum_weight = 0;
     for (uint64_t i=0; i<dist.size(); i++) {
         sum_weight += dist[i];
     }
-    double r = v * sum_weight;
+    if (sum_weight <= 0) { // every weight is zero, pick uniformly
+        return uint64_t(v * dist.size());
+    }
+    weight_t r = weight_t(v * sum_weight);
+    if (r >= sum_weight) {
+        r = sum_weight - 1;
+    }
 
     uint64_t i = 0;
     while (true) {
-        double w = dist[i];
+        weight_t w = dist[i];
         if (r < w) {
             return i;
         }
@@ -33,94 +71,597 @@ uint64_t weighted_random(const std::vector<double>& dist, double v) {
     }
 }
 
-using var_t = uint64_t;
-using lit_t = int64_t;
-using clause_t = std::vector<lit_t>;
-using weight_t = double;
+// weight_scale - smallest power of 10 that makes every soft weight an integer up to a relative error and keeps
+// nonzero weights nonzero, otherwise the power of 2 fixed point scale that keeps the total weight exact in double
+double weight_scale(uint64_t num_clauses, const double* clause_weight, const int8_t* clause_hard) {
+    const double max_sum = std::ldexp(1.0, 53);
+    double sum_weight = 0;
+    for (uint64_t c=0; c < num_clauses; c++) {
+        if (clause_hard[c] == 0) {
+            sum_weight += std::abs(clause_weight[c]);
+        }
+    }
+    double scale = 1;
+    for (uint64_t k=0; k <= 9; k++) {
+        if (sum_weight * scale >= max_sum) {
+            break;
+        }
+        bool exact = true;
+        for (uint64_t c=0; c < num_clauses; c++) {
+            double w = clause_weight[c] * scale;
+            if (clause_hard[c] == 0 and (std::abs(w - std::round(w)) > 1e-9 * std::abs(w) or (w != 0 and std::round(w) == 0))) {
+                exact = false;
+                break;
+            }
+        }
+        if (exact) {
+            return scale;
+        }
+        scale *= 10;
+    }
+    // rational weights without a short decimal expansion, round to fixed point
+    if (sum_weight == 0) {
+        return 1;
+    }
+    return std::ldexp(1.0, std::ilogb(max_sum / sum_weight));
+}
+
+void init_problem(problem& problem, uint64_t num_variables, uint64_t num_clauses, uint64_t num_literals, bool huge_pages) {
+    problem.huge_pages = huge_pages;
+    problem.lit_list = arena_vector<lit_t>(arena_allocator<lit_t>(huge_pages));
+    problem.lit_list.reserve(num_literals);
+    problem.clause_start = arena_vector<uint64_t>(arena_allocator<uint64_t>(huge_pages));
+    problem.clause_start.reserve(num_clauses + 1);
+    problem.clause_start.push_back(0);
+    problem.weight_list.clear();
+    problem.weight_list.reserve(num_clauses);
+    problem.hard_list.clear();
+    problem.hard_list.reserve(num_clauses);
+    problem.occur_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(huge_pages));
+    problem.occur_start = arena_vector<uint64_t>(arena_allocator<uint64_t>(huge_pages));
+    problem.num_variables = num_variables;
+    problem.num_clauses = 0;
+    problem.num_hard_clauses = 0;
+}
 
-using val_t = int8_t; // 0, -1, +1
-using assign_t = std::vector<val_t>;
+void push_clause(problem& problem, const lit_t* first, const lit_t* last, weight_t weight, bool hard) {
+    problem.lit_list.insert(problem.lit_list.end(), first, last);
+    problem.clause_start.push_back(problem.lit_list.size());
+    problem.weight_list.push_back(hard ? 0 : weight);
+    problem.hard_list.push_back(hard);
+    problem.num_clauses++;
+    problem.num_hard_clauses += hard;
+}
 
-struct problem {
-    std::vector<clause_t> clause_list;
-    std::vector<weight_t> weight_list;
-    uint64_t num_variables;
+void make_occur_list(problem& problem) {
+    // count, prefix sum, then fill each list from its end
+    uint64_t num_lits = 2 * (problem.num_variables + 1);
+    problem.occur_start.assign(num_lits + 1, 0);
+    for (lit_t lit : problem.lit_list) {
+        problem.occur_start[lit_index(lit) + 1]++;
+    }
+    for (uint64_t l=0; l < num_lits; l++) {
+        problem.occur_start[l + 1] += problem.occur_start[l];
+    }
+    problem.occur_list.assign(problem.occur_start[num_lits], 0);
+    std::vector<uint64_t> occur_end(problem.occur_start.begin() + 1, problem.occur_start.end());
+    for (uint64_t i=problem.num_clauses; i > 0; i--) {
+        uint64_t c = i - 1;
+        for (lit_t lit : get_clause(problem, c)) {
+            problem.occur_list[--occur_end[lit_index(lit)]] = c;
+        }
+    }
+}
+
+// var_state - everything a flip reads or writes about a var, a var takes a cache line of its own
+struct alignas(CACHE_LINE_SIZE) var_state {
+    weight_t flip_hard_change; // gain this search weight of unsat hard clauses if var is flipped
+    weight_t flip_weight_change; // gain this search weight of unsat soft clauses if var is flipped
+    uint64_t break_hard; // number of hard clauses var is the only sat var of
+    uint64_t break_soft; // number of soft clauses var is the only sat var of
+    uint64_t flip_step; // value of num_flips when var was last flipped, 0 if never
+    val_t value; // +1: true, -1: false
+    bool improving_listed; // var is in improving_var_list
+};
+
+// clause_state - everything a flip reads or writes about a clause, two clauses share a cache line
+struct alignas(CACHE_LINE_SIZE / 2) clause_state {
+    uint64_t sat_count; // number of sat literals
+    var_t sat_var_xor; // xor of sat vars, the only sat var if sat_count is 1
+    uint64_t unsat_pos; // position of unsat clause in its unsat list
+    weight_t search_weight; // weight used for scoring, the objective uses problem.weight_list
 };
 
+// solution - per var and per clause search state in var_list and clause_list, the rest is touched
+// once per pick or less
 struct solution {
-    assign_t assignment;
-    weight_t assignment_weight; // weighted sum of unsat clauses
-    std::vector<uint64_t> clause_unsat_idx_list; // list of unsat clause indices
-    std::vector<double> clause_unsat_idx_dist; // weight of unsat clauses 
-    std::vector<weight_t> var_flip_weight_change; // gain this amount of weight if var[i] is flipped
+    arena_vector<var_state> var_list; // indexed by var, var_list[0] is unused
+    arena_vector<clause_state> clause_list;
+    uint64_t assignment_hard; // number of unsat hard clauses
+    weight_t assignment_weight; // weighted sum of unsat soft clauses
+    arena_vector<uint64_t> clause_unsat_hard_idx_list; // list of unsat hard clause indices
+    arena_vector<uint64_t> clause_unsat_idx_list; // list of unsat soft clause indices
+    arena_vector<weight_t> clause_unsat_idx_dist; // weight of unsat soft clauses
+    weight_t sum_search_weight_hard; // sum of search_weight over hard clauses
+    weight_t sum_search_weight_soft; // sum of search_weight over soft clauses
+    uint64_t num_flips; // flips since init_solution
+    arena_vector<var_t> improving_var_list; // vars whose flip may decrease the search cost, stale entries are removed lazily
+    arena_vector<int8_t> lit_truth; // -1 at lit_index of sat literals, 0 elsewhere, filled by eval_solution
 };
 
-// init_solution - 
+// reserve_solution - every list of solution takes the room it can grow to from pool up front
+void reserve_solution(const problem& problem, solution& solution, arena& pool) {
+    uint64_t num_soft_clauses = problem.num_clauses - problem.num_hard_clauses;
+    solution.var_list = arena_vector<var_state>(arena_allocator<var_state>(&pool));
+    solution.var_list.reserve(problem.num_variables + 1);
+    solution.clause_list = arena_vector<clause_state>(arena_allocator<clause_state>(&pool));
+    solution.clause_list.reserve(problem.num_clauses);
+    solution.clause_unsat_hard_idx_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(&pool));
+    solution.clause_unsat_hard_idx_list.reserve(problem.num_hard_clauses);
+    solution.clause_unsat_idx_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(&pool));
+    solution.clause_unsat_idx_list.reserve(num_soft_clauses);
+    solution.clause_unsat_idx_dist = arena_vector<weight_t>(arena_allocator<weight_t>(&pool));
+    solution.clause_unsat_idx_dist.reserve(num_soft_clauses);
+    solution.improving_var_list = arena_vector<var_t>(arena_allocator<var_t>(&pool));
+    solution.improving_var_list.reserve(problem.num_variables + 1);
+    solution.lit_truth = arena_vector<int8_t>(arena_allocator<int8_t>(&pool));
+    solution.lit_truth.reserve(2 * (problem.num_variables + 1) + LIT_TRUTH_PADDING);
+}
+
+// solution_arena_size - room reserve_solution takes
+uint64_t solution_arena_size(const problem& problem) {
+    uint64_t num_soft_clauses = problem.num_clauses - problem.num_hard_clauses;
+    return arena_array_size<var_state>(problem.num_variables + 1) + arena_array_size<clause_state>(problem.num_clauses)
+        + arena_array_size<uint64_t>(problem.num_hard_clauses) + arena_array_size<uint64_t>(num_soft_clauses)
+        + arena_array_size<weight_t>(num_soft_clauses) + arena_array_size<var_t>(problem.num_variables + 1)
+        + arena_array_size<int8_t>(2 * (problem.num_variables + 1) + LIT_TRUTH_PADDING);
+}
+
+// get_assignment - values of every var
+void get_assignment(const solution& solution, assign_t& assignment) {
+    assignment.resize(solution.var_list.size());
+    for (var_t var=0; var < solution.var_list.size(); var++) {
+        assignment[var] = solution.var_list[var].value;
+    }
+}
+
+// set_assignment - start over from assignment, eval_solution fills in the rest
+void set_assignment(solution& solution, const assign_t& assignment) {
+    solution.num_flips = 0;
+    solution.var_list.assign(assignment.size(), var_state());
+    for (var_t var=0; var < assignment.size(); var++) {
+        solution.var_list[var].value = assignment[var];
+    }
+}
+
+// less_cost - hard cost first, soft cost breaks ties
+template<typename H, typename S> bool less_cost(H hard_a, S soft_a, H hard_b, S soft_b) {
+    if (hard_a != hard_b) {
+        return hard_a < hard_b;
+    }
+    return soft_a < soft_b;
+}
+
+// improving_var - flipping var decreases the search cost
+bool improving_var(const solution& solution, var_t var) {
+    return less_cost<weight_t, weight_t>(solution.var_list[var].flip_hard_change, solution.var_list[var].flip_weight_change, 0, 0);
+}
+
+// add_var_change - update flip change of var for a hard or soft clause, a decrease may make var improving
+inline void add_var_change(solution& solution, bool hard, var_t var, weight_t delta) {
+    if (hard) {
+        solution.var_list[var].flip_hard_change += delta;
+    } else {
+        solution.var_list[var].flip_weight_change += delta;
+    }
+    if (delta < 0 and not solution.var_list[var].improving_listed and improving_var(solution, var)) {
+        solution.var_list[var].improving_listed = true;
+        solution.improving_var_list.push_back(var);
+    }
+}
+
+// add_var_break - var becomes (+1) or stops being (-1) the only sat var of a clause
+inline void add_var_break(solution& solution, bool hard, var_t var, int64_t delta) {
+    if (hard) {
+        solution.var_list[var].break_hard += delta;
+    } else {
+        solution.var_list[var].break_soft += delta;
+    }
+}
+
+// init_solution -
 void init_solution(const problem& problem, solution& solution, rand_t rand) {
-    solution.assignment.clear();
-    solution.assignment.push_back(0);
-    for (uint64_t i=0; i < problem.num_variables; i++) {
+    solution.num_flips = 0;
+    solution.var_list.assign(problem.num_variables + 1, var_state());
+    for (var_t var=1; var <= problem.num_variables; var++) {
         if (rand() >= 0.5) {
-            solution.assignment.push_back(+1);
+            solution.var_list[var].value = +1;
+        } else {
+            solution.var_list[var].value = -1;
+        }
+    }
+}
+
+// better_polarity - occurrences of lit outweigh those of -lit, hard clauses first then soft weight
+bool better_polarity(const problem& problem, lit_t lit) {
+    int64_t hard_count = 0;
+    weight_t soft_weight = 0;
+    for (uint64_t c : get_occur(problem, lit)) {
+        if (problem.hard_list[c]) {
+            hard_count++;
+        } else {
+            soft_weight += problem.weight_list[c];
+        }
+    }
+    for (uint64_t c : get_occur(problem, -lit)) {
+        if (problem.hard_list[c]) {
+            hard_count--;
         } else {
-            solution.assignment.push_back(-1);
+            soft_weight -= problem.weight_list[c];
+        }
+    }
+    return less_cost<int64_t, weight_t>(0, 0, hard_count, soft_weight);
+}
+
+// get_polarity - better polarity of every var, +1 or -1, 0 on a tie
+void get_polarity(const problem& problem, assign_t& polarity) {
+    polarity.assign(problem.num_variables + 1, 0);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        if (better_polarity(problem, lit_t(var))) {
+            polarity[var] = +1;
+        } else if (better_polarity(problem, -lit_t(var))) {
+            polarity[var] = -1;
+        }
+    }
+}
+
+// init_polarity_solution - every var takes the polarity with the most weighted occurrences, ties at random
+void init_polarity_solution(const problem& problem, const assign_t& polarity, solution& solution, rand_t rand) {
+    init_solution(problem, solution, rand);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        if (polarity[var] != 0) {
+            solution.var_list[var].value = polarity[var];
+        }
+    }
+}
+
+// init_greedy_solution - satisfy clauses one by one (hard, short and heavy first) by setting an unassigned
+// literal with the better polarity, the remaining vars take their polarity
+void init_greedy_solution(const problem& problem, solution& solution, rand_t rand) {
+    assign_t polarity;
+    get_polarity(problem, polarity);
+    std::vector<uint64_t> order(problem.num_clauses);
+    for (uint64_t i=0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&problem](uint64_t a, uint64_t b) {
+        if (problem.hard_list[a] != problem.hard_list[b]) {
+            return bool(problem.hard_list[a]);
+        }
+        if (get_clause(problem, a).size() != get_clause(problem, b).size()) {
+            return get_clause(problem, a).size() < get_clause(problem, b).size();
+        }
+        return problem.weight_list[a] > problem.weight_list[b];
+    });
+    assign_t greedy(problem.num_variables + 1, 0);
+    for (uint64_t c : order) {
+        lit_t pick_lit = 0;
+        bool sat = false;
+        for (lit_t lit : get_clause(problem, c)) {
+            val_t val = greedy[abs(lit)];
+            if (lit * val > 0) {
+                sat = true;
+                break;
+            }
+            if (val == 0 and (pick_lit == 0 or lit * polarity[abs(lit)] > 0)) {
+                pick_lit = lit;
+            }
+        }
+        if (not sat and pick_lit != 0) {
+            greedy[abs(pick_lit)] = pick_lit > 0 ? +1 : -1;
+        }
+    }
+    init_polarity_solution(problem, polarity, solution, rand);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        if (greedy[var] != 0) {
+            solution.var_list[var].value = greedy[var];
+        }
+    }
+}
+
+// initial_search_weight - hard clauses start from base_weight, soft clauses from their objective weight in units of base_weight
+weight_t initial_search_weight(const problem& problem, uint64_t c, weight_t base_weight) {
+    return problem.hard_list[c] ? base_weight : base_weight * problem.weight_list[c];
+}
+
+// init_search_weight - every clause starts from its initial_search_weight
+void init_search_weight(const problem& problem, solution& solution, weight_t base_weight) {
+    solution.clause_list.assign(problem.num_clauses, clause_state());
+    solution.sum_search_weight_hard = 0;
+    solution.sum_search_weight_soft = 0;
+    for (uint64_t i=0; i < problem.num_clauses; i++) {
+        solution.clause_list[i].search_weight = initial_search_weight(problem, i, base_weight);
+        if (problem.hard_list[i]) {
+            solution.sum_search_weight_hard += solution.clause_list[i].search_weight;
+        } else {
+            solution.sum_search_weight_soft += solution.clause_list[i].search_weight;
+        }
+    }
+}
+
+void add_unsat_clause(const problem& problem, solution& solution, uint64_t c) {
+    arena_vector<uint64_t>& unsat_list = problem.hard_list[c] ? solution.clause_unsat_hard_idx_list : solution.clause_unsat_idx_list;
+    solution.clause_list[c].unsat_pos = unsat_list.size();
+    unsat_list.push_back(c);
+    if (problem.hard_list[c]) {
+        solution.assignment_hard += 1;
+    } else {
+        solution.assignment_weight += problem.weight_list[c];
+    }
+}
+
+void remove_unsat_clause(const problem& problem, solution& solution, uint64_t c) {
+    arena_vector<uint64_t>& unsat_list = problem.hard_list[c] ? solution.clause_unsat_hard_idx_list : solution.clause_unsat_idx_list;
+    uint64_t pos = solution.clause_list[c].unsat_pos;
+    uint64_t last = unsat_list.back();
+    unsat_list[pos] = last;
+    solution.clause_list[last].unsat_pos = pos;
+    unsat_list.pop_back();
+    if (problem.hard_list[c]) {
+        solution.assignment_hard -= 1;
+    } else {
+        solution.assignment_weight -= problem.weight_list[c];
+    }
+}
+
+// eval_clause - set the sat state of clause c and add it to the scores and the cost
+void eval_clause(const problem& problem, solution& solution, uint64_t c, uint64_t sat_var_count, var_t sat_var_xor) {
+    weight_t weight = solution.clause_list[c].search_weight;
+    bool hard = problem.hard_list[c];
+    solution.clause_list[c].sat_count = sat_var_count;
+    solution.clause_list[c].sat_var_xor = sat_var_xor;
+    solution.clause_list[c].unsat_pos = 0;
+    if (sat_var_count == 1) {
+        // the only sat var makes the clause sat and if it is flipped, clause becomes unsat
+        add_var_change(solution, hard, sat_var_xor, +weight);
+        add_var_break(solution, hard, sat_var_xor, +1);
+    }
+    if (sat_var_count == 0) {
+        // every var makes the clause sat if it is flipped
+        for (lit_t lit : get_clause(problem, c)) {
+            add_var_change(solution, hard, abs(lit), -weight);
         }
+        // add to list of unsat clause and update cost
+        add_unsat_clause(problem, solution, c);
     }
 }
 
-// eval_solution - given assignment fill in its values
-void eval_solution(const problem& problem, solution& solution) {
+const uint64_t EVAL_BLOCK_SIZE = 1024; // literals eval_solution hands to sat_literal_vars at a time
+
+// eval_solution - given assignment and search weights fill in its values
+WALKSAT_MULTIVERSION void eval_solution(const problem& problem, solution& solution) {
     // reset
+    uint64_t num_clauses = problem.num_clauses;
+    solution.clause_unsat_hard_idx_list.clear();
     solution.clause_unsat_idx_list.clear();
-    solution.var_flip_weight_change.clear();
-    solution.var_flip_weight_change.push_back(0);
-    for (uint64_t i=0; i < problem.num_variables; i++) {
-        solution.var_flip_weight_change.push_back(0);
+    for (var_t var=0; var <= problem.num_variables; var++) {
+        var_state& state = solution.var_list[var];
+        state.flip_hard_change = 0;
+        state.flip_weight_change = 0;
+        state.break_hard = 0;
+        state.break_soft = 0;
+        state.improving_listed = false;
     }
+    solution.improving_var_list.clear();
+    solution.assignment_hard = 0;
     solution.assignment_weight = 0;
-    // eval
-    for (uint64_t i=0; i < problem.clause_list.size(); i++) {
-        weight_t weight = problem.weight_list[i];
-        const clause_t& clause = problem.clause_list[i];
-        // process
-        bool sat = false;
-        var_t last_sat_var;
-        uint64_t sat_var_count = 0;
-        for (uint64_t j=0; j < clause.size(); j++) {
-            lit_t lit = clause[j];
-            var_t var = abs(lit);
-            val_t val = solution.assignment[var];
-            if (lit * val > 0) { // sat
-                sat = true;
-                last_sat_var = var;
-                sat_var_count += 1;
-                if (sat_var_count == 2) {
-                    break;
-                }
+    // truth of every literal
+    solution.lit_truth.assign(2 * (problem.num_variables + 1) + LIT_TRUTH_PADDING, 0);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        val_t val = solution.var_list[var].value;
+        if (val != 0) {
+            solution.lit_truth[lit_index(val * lit_t(var))] = -1;
+        }
+    }
+    // eval, the literals of the clause store are classified a block at a time, a clause may span blocks
+    const uint64_t* clause_start = problem.clause_start.data();
+    uint64_t num_literals = problem.lit_list.size();
+    var_t sat_var[EVAL_BLOCK_SIZE];
+    uint64_t c = 0;
+    uint64_t sat_var_count = 0;
+    var_t sat_var_xor = 0;
+    for (uint64_t first=0; first < num_literals; first += EVAL_BLOCK_SIZE) {
+        uint64_t last = std::min(first + EVAL_BLOCK_SIZE, num_literals);
+        sat_literal_vars(problem.lit_list.data() + first, problem.lit_list.data() + last, solution.lit_truth.data(), sat_var);
+        while (c < num_clauses) {
+            uint64_t end = std::min(clause_start[c + 1], last);
+            for (uint64_t j=std::max(clause_start[c], first); j < end; j++) {
+                sat_var_count += sat_var[j - first] != 0;
+                sat_var_xor ^= sat_var[j - first];
             }
+            if (clause_start[c + 1] > last) {
+                break; // continues in the next block
+            }
+            eval_clause(problem, solution, c, sat_var_count, sat_var_xor);
+            c++;
+            sat_var_count = 0;
+            sat_var_xor = 0;
         }
-        // post process
-        if (sat and sat_var_count == 1) {
-            // last_sat_var makes the clause sat and if it is flipped, clause becomes unsat
-            solution.var_flip_weight_change[last_sat_var] += weight;
+    }
+    for (; c < num_clauses; c++) { // empty clauses past the last literal
+        eval_clause(problem, solution, c, 0, 0);
+    }
+}
+
+// flip_var - flip var and update the values of solution incrementally
+void flip_var(const problem& problem, solution& solution, var_t var) {
+    solution.var_list[var].value *= -1;
+    solution.var_list[var].flip_step = ++solution.num_flips;
+    lit_t sat_lit = solution.var_list[var].value > 0 ? lit_t(var) : -lit_t(var);
+    auto clause_address = [&solution](uint64_t c) { return &solution.clause_list[c]; };
+    // clauses that gain a sat literal
+    list_view<uint64_t> occur = get_occur(problem, sat_lit);
+    for (uint64_t i=0; i < occur.size(); i++) {
+        prefetch_ahead(occur, i, clause_address);
+        uint64_t c = occur[i];
+        weight_t weight = solution.clause_list[c].search_weight;
+        bool hard = problem.hard_list[c];
+        uint64_t count = ++solution.clause_list[c].sat_count;
+        if (count == 1) {
+            // unsat -> sat, no var makes it sat anymore, var breaks it
+            for (lit_t lit : get_clause(problem, c)) {
+                add_var_change(solution, hard, abs(lit), +weight);
+            }
+            add_var_change(solution, hard, var, +weight);
+            add_var_break(solution, hard, var, +1);
+            remove_unsat_clause(problem, solution, c);
+        } else if (count == 2) {
+            // the previously only sat var no longer breaks it
+            add_var_change(solution, hard, solution.clause_list[c].sat_var_xor, -weight);
+            add_var_break(solution, hard, solution.clause_list[c].sat_var_xor, -1);
         }
-        if (not sat) {
-            // every var makes the clause sat if it is flipped
-            for (uint64_t j=0; j < clause.size(); j++) {
-                lit_t lit = clause[j];
-                var_t var = abs(lit);
-                solution.var_flip_weight_change[var] -= weight;
+        solution.clause_list[c].sat_var_xor ^= var;
+    }
+    // clauses that lose a sat literal
+    occur = get_occur(problem, -sat_lit);
+    for (uint64_t i=0; i < occur.size(); i++) {
+        prefetch_ahead(occur, i, clause_address);
+        uint64_t c = occur[i];
+        weight_t weight = solution.clause_list[c].search_weight;
+        bool hard = problem.hard_list[c];
+        uint64_t count = --solution.clause_list[c].sat_count;
+        solution.clause_list[c].sat_var_xor ^= var;
+        if (count == 0) {
+            // sat -> unsat, var no longer breaks it, every var makes it sat
+            add_var_change(solution, hard, var, -weight);
+            add_var_break(solution, hard, var, -1);
+            for (lit_t lit : get_clause(problem, c)) {
+                add_var_change(solution, hard, abs(lit), -weight);
             }
-            // add to list of unsat clause
-            solution.clause_unsat_idx_list.push_back(i);
-            // update weight
-            solution.assignment_weight += weight;
+            add_unsat_clause(problem, solution, c);
+        } else if (count == 1) {
+            // the remaining sat var breaks it
+            add_var_change(solution, hard, solution.clause_list[c].sat_var_xor, +weight);
+            add_var_break(solution, hard, solution.clause_list[c].sat_var_xor, +1);
+        }
+    }
+}
+
+// add_search_weight - change search weight of clause by delta and update scores
+void add_search_weight(const problem& problem, solution& solution, uint64_t c, weight_t delta) {
+    solution.clause_list[c].search_weight += delta;
+    bool hard = problem.hard_list[c];
+    if (hard) {
+        solution.sum_search_weight_hard += delta;
+    } else {
+        solution.sum_search_weight_soft += delta;
+    }
+    if (solution.clause_list[c].sat_count == 0) {
+        for (lit_t lit : get_clause(problem, c)) {
+            add_var_change(solution, hard, abs(lit), -delta);
+        }
+    } else if (solution.clause_list[c].sat_count == 1) {
+        add_var_change(solution, hard, solution.clause_list[c].sat_var_xor, +delta);
+    }
+}
+
+// objective_change - change of the objective cost if var is flipped, independent of the search weights
+void objective_change(const problem& problem, const solution& solution, var_t var, int64_t& hard_change, weight_t& weight_change) {
+    hard_change = 0;
+    weight_change = 0;
+    lit_t sat_lit = solution.var_list[var].value > 0 ? lit_t(var) : -lit_t(var);
+    for (uint64_t c : get_occur(problem, sat_lit)) {
+        if (solution.clause_list[c].sat_count == 1) { // breaks
+            if (problem.hard_list[c]) {
+                hard_change += 1;
+            } else {
+                weight_change += problem.weight_list[c];
+            }
+        }
+    }
+    for (uint64_t c : get_occur(problem, -sat_lit)) {
+        if (solution.clause_list[c].sat_count == 0) { // makes
+            if (problem.hard_list[c]) {
+                hard_change -= 1;
+            } else {
+                weight_change -= problem.weight_list[c];
+            }
+        }
+    }
+}
+
+// tabu parameters
+const double TABU_ADAPT_THETA = 1.0 / 6; // stagnation after THETA * num_clauses flips without improvement
+const double TABU_ADAPT_PHI = 0.2;
+const uint64_t TABU_MIN_MAX_TENURE = 16; // adaptive tenure grows up to 4 * base tenure, at least this
+
+struct tabu_state {
+    uint64_t tenure; // a var flipped less than tenure flips ago is tabu, 0 disables tabu
+    uint64_t base_tenure;
+    uint64_t max_tenure;
+    bool adaptive;
+    uint64_t adapt_step; // num_flips at the last tenure change
+    uint64_t adapt_hard; // cost at the last tenure change
+    weight_t adapt_weight;
+    uint64_t best_hard; // best cost so far, a tabu flip reaching a new best is allowed
+    weight_t best_weight;
+    uint64_t num_blocked; // tabu vars skipped
+};
+
+// tabu_allowed - var is not tabu, or flipping it gives a new best cost (aspiration)
+bool tabu_allowed(const problem& problem, const solution& solution, tabu_state& tabu, var_t var) {
+    if (tabu.tenure == 0 or solution.var_list[var].flip_step == 0 or solution.num_flips - solution.var_list[var].flip_step >= tabu.tenure) {
+        return true;
+    }
+    int64_t hard_change;
+    weight_t weight_change;
+    objective_change(problem, solution, var, hard_change, weight_change);
+    if (less_cost<int64_t, weight_t>(solution.assignment_hard + hard_change, solution.assignment_weight + weight_change, tabu.best_hard, tabu.best_weight)) {
+        return true;
+    }
+    tabu.num_blocked++;
+    return false;
+}
+
+// adapt_tabu_tenure - lengthen the tenure on stagnation, shorten it on improvement
+void adapt_tabu_tenure(const problem& problem, const solution& solution, tabu_state& tabu) {
+    if (less_cost(solution.assignment_hard, solution.assignment_weight, tabu.adapt_hard, tabu.adapt_weight)) {
+        tabu.tenure -= uint64_t((tabu.tenure - tabu.base_tenure) * TABU_ADAPT_PHI / 2);
+    } else if (solution.num_flips - tabu.adapt_step > TABU_ADAPT_THETA * problem.num_clauses) {
+        tabu.tenure += uint64_t(std::ceil((tabu.max_tenure - tabu.tenure) * TABU_ADAPT_PHI));
+    } else {
+        return;
+    }
+    tabu.adapt_step = solution.num_flips;
+    tabu.adapt_hard = solution.assignment_hard;
+    tabu.adapt_weight = solution.assignment_weight;
+}
+
+// oldest_var - var of the clause flipped longest ago
+var_t oldest_var(const solution& solution, clause_view clause) {
+    var_t flip_var = 0;
+    for (lit_t lit : clause) {
+        if (flip_var == 0 or solution.var_list[abs(lit)].flip_step < solution.var_list[flip_var].flip_step) {
+            flip_var = abs(lit);
+        }
+    }
+    return flip_var;
+}
+
+// pick_random_var - uniformly random var of the clause that is not tabu, the oldest var if every var is tabu
+var_t pick_random_var(const problem& problem, const solution& solution, tabu_state& tabu, clause_view clause, rand_t rand) {
+    uint64_t start = uint64_t(rand() * clause.size());
+    for (uint64_t j=0; j < clause.size(); j++) {
+        var_t var = abs(clause[(start + j) % clause.size()]);
+        if (tabu_allowed(problem, solution, tabu, var)) {
+            return var;
         }
     }
+    return oldest_var(solution, clause);
 }
 
 void make_clause_unsat_dist(const problem& problem, solution& solution) {
-    // reset 
+    // reset
     solution.clause_unsat_idx_dist.clear();
     // set
     for (uint64_t i=0; i < solution.clause_unsat_idx_list.size(); i++) {
@@ -129,114 +670,1073 @@ void make_clause_unsat_dist(const problem& problem, solution& solution) {
     }
 }
 
-solution local_search_problem(const problem& problem, uint64_t seed, uint64_t max_time_s, double random_flip_prob, double reset_prob) {
+// pick_best_var - var in clause with least hard change, then least soft change, skipping tabu vars
+var_t pick_best_var(const problem& problem, const solution& solution, tabu_state& tabu, uint64_t c) {
+    var_t flip_var = 0;
+    weight_t best_hard_change = std::numeric_limits<weight_t>::max();
+    weight_t best_weight_change = std::numeric_limits<weight_t>::max();
+    for (lit_t lit : get_clause(problem, c)) {
+        var_t var = abs(lit);
+        if (not tabu_allowed(problem, solution, tabu, var)) {
+            continue;
+        }
+        if (less_cost(solution.var_list[var].flip_hard_change, solution.var_list[var].flip_weight_change, best_hard_change, best_weight_change)) {
+            best_hard_change = solution.var_list[var].flip_hard_change;
+            best_weight_change = solution.var_list[var].flip_weight_change;
+            flip_var = var;
+        }
+    }
+    if (flip_var == 0) {
+        return oldest_var(solution, get_clause(problem, c));
+    }
+    return flip_var;
+}
+
+// better_var - less hard change, then less soft change, then flipped longer ago
+bool better_var(const solution& solution, var_t a, var_t b) {
+    if (solution.var_list[a].flip_hard_change != solution.var_list[b].flip_hard_change) {
+        return solution.var_list[a].flip_hard_change < solution.var_list[b].flip_hard_change;
+    }
+    if (solution.var_list[a].flip_weight_change != solution.var_list[b].flip_weight_change) {
+        return solution.var_list[a].flip_weight_change < solution.var_list[b].flip_weight_change;
+    }
+    return solution.var_list[a].flip_step < solution.var_list[b].flip_step;
+}
+
+// pick_improving_var - best var among improving vars that are not tabu, 0 if there is none,
+// promising_only skips the var flipped last, whose improvement only undoes that flip (G2WSAT)
+var_t pick_improving_var(const problem& problem, solution& solution, tabu_state& tabu, bool promising_only) {
+    var_t flip_var = 0;
+    for (uint64_t i=solution.improving_var_list.size(); i > 0; i--) {
+        var_t var = solution.improving_var_list[i-1];
+        if (not improving_var(solution, var)) {
+            // stale entry
+            solution.var_list[var].improving_listed = false;
+            solution.improving_var_list[i-1] = solution.improving_var_list.back();
+            solution.improving_var_list.pop_back();
+            continue;
+        }
+        if (promising_only and solution.num_flips > 0 and solution.var_list[var].flip_step == solution.num_flips) {
+            continue;
+        }
+        if ((flip_var == 0 or better_var(solution, var, flip_var)) and tabu_allowed(problem, solution, tabu, var)) {
+            flip_var = var;
+        }
+    }
+    return flip_var;
+}
+
+// walksat_pick_clause - random unsat hard clause, or unsat soft clause by objective weight
+uint64_t walksat_pick_clause(const problem& problem, solution& solution, rand_t rand) {
+    if (solution.clause_unsat_hard_idx_list.size() > 0) {
+        // repair hard clauses first, pick random unsat hard clause uniformly
+        uint64_t i = uint64_t(rand() * solution.clause_unsat_hard_idx_list.size());
+        return solution.clause_unsat_hard_idx_list[i];
+    }
+    // pick random unsat soft clause according to weight
+    make_clause_unsat_dist(problem, solution);
+    uint64_t i = weighted_random(solution.clause_unsat_idx_dist, rand());
+    return solution.clause_unsat_idx_list[i];
+}
+
+// walksat_pick_var - with promising, the best promising improving var if any (G2WSAT),
+// otherwise pick unsat clause by objective weight then greedy or random var in it
+var_t walksat_pick_var(const problem& problem, solution& solution, rand_t rand, double random_flip_prob, tabu_state& tabu, bool promising, uint64_t& num_promising_flips) {
+    if (promising) {
+        var_t flip_var = pick_improving_var(problem, solution, tabu, true);
+        if (flip_var != 0) {
+            num_promising_flips++;
+            return flip_var;
+        }
+    }
+    uint64_t c = walksat_pick_clause(problem, solution, rand);
+    clause_view clause = get_clause(problem, c);
+    if (rand() < random_flip_prob) {
+        // with random_flip_prob, pick random var uniformly in clause
+        return pick_random_var(problem, solution, tabu, clause, rand);
+    }
+    // pick the var with least hard change, then least weight change
+    return pick_best_var(problem, solution, tabu, c);
+}
+
+// clause weighting parameters
+const weight_t PAWS_BASE_WEIGHT = 1;
+const uint64_t PAWS_SMOOTH_PERIOD = 10; // decrease heavy clauses after this many increases
+const weight_t SAPS_BASE_WEIGHT = 1000; // fixed point 1.0
+const double SAPS_ALPHA = 1.3; // scaling of unsat clauses
+const double SAPS_RHO = 0.8; // smoothing towards the mean
+const double SAPS_SMOOTH_PROB = 0.05;
+const weight_t SAPS_MAX_WEIGHT = weight_t(1) << 40;
+const weight_t DDFW_BASE_WEIGHT = 8;
+const uint64_t DDFW_DONOR_TRIES = 8; // random satisfied clauses tried when no neighbour can donate
+const double DDFW_SIDEWAYS_PROB = 0.15; // flip a var that leaves the weighted cost unchanged instead of transferring weight
+const double DDFW_RANDOM_DONOR_PROB = 0.05; // donor is a random satisfied clause, two neighbours otherwise pass weight back and forth
+const weight_t SWT_BASE_WEIGHT = 1;
+const weight_t SWT_THRESHOLD = 50; // smooth once the mean weight exceeds this, CCAnr defaults
+const double SWT_P = 0.3;
+const double SWT_Q = 0.7;
+
+struct weighting_state {
+    uint64_t num_increases = 0;
+    arena_vector<uint64_t> heavy_clause_list; // clauses with search weight above their initial weight
+    arena_vector<bool> heavy_clause;
+    double initial_mean_soft = 1; // mean initial search weight of the soft clauses, at least 1
+};
+
+weight_t base_search_weight(uint64_t weighting) {
+    switch (weighting) {
+        case WALKSAT_WEIGHTING_SAPS:
+            return SAPS_BASE_WEIGHT;
+        case WALKSAT_WEIGHTING_DDFW:
+            return DDFW_BASE_WEIGHT;
+        case WALKSAT_WEIGHTING_SWT:
+            return SWT_BASE_WEIGHT;
+        default:
+            return PAWS_BASE_WEIGHT;
+    }
+}
+
+// unsat_search_list - clauses whose weights are increased at a local minimum, hard clauses first
+const arena_vector<uint64_t>& unsat_search_list(const solution& solution) {
+    if (solution.clause_unsat_hard_idx_list.size() > 0) {
+        return solution.clause_unsat_hard_idx_list;
+    }
+    return solution.clause_unsat_idx_list;
+}
+
+// paws_update - additive increase of unsat clauses, periodic decrease of heavy clauses
+void paws_update(const problem& problem, solution& solution, weighting_state& state) {
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    for (uint64_t i=0; i < unsat_list.size(); i++) {
+        uint64_t c = unsat_list[i];
+        add_search_weight(problem, solution, c, +1);
+        if (not state.heavy_clause[c]) {
+            state.heavy_clause[c] = true;
+            state.heavy_clause_list.push_back(c);
+        }
+    }
+    state.num_increases++;
+    if (state.num_increases % PAWS_SMOOTH_PERIOD != 0) {
+        return;
+    }
+    for (uint64_t i=state.heavy_clause_list.size(); i > 0; i--) {
+        uint64_t c = state.heavy_clause_list[i-1];
+        add_search_weight(problem, solution, c, -1);
+        if (solution.clause_list[c].search_weight <= initial_search_weight(problem, c, PAWS_BASE_WEIGHT)) {
+            state.heavy_clause[c] = false;
+            state.heavy_clause_list[i-1] = state.heavy_clause_list.back();
+            state.heavy_clause_list.pop_back();
+        }
+    }
+}
+
+// saps_update - multiplicative increase of unsat clauses, occasional smoothing towards the mean
+WALKSAT_MULTIVERSION void saps_update(const problem& problem, solution& solution, rand_t rand) {
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    for (uint64_t i=0; i < unsat_list.size(); i++) {
+        uint64_t c = unsat_list[i];
+        weight_t weight = solution.clause_list[c].search_weight;
+        weight_t new_weight = std::max(weight, std::min(SAPS_MAX_WEIGHT, weight_t(std::llround(weight * SAPS_ALPHA))));
+        add_search_weight(problem, solution, c, new_weight - weight);
+    }
+    if (rand() >= SAPS_SMOOTH_PROB) {
+        return;
+    }
+    // hard and soft weights are smoothed towards their own mean
+    double sum_weight[2] = {0, 0};
+    uint64_t count[2] = {0, 0};
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        sum_weight[problem.hard_list[c]] += solution.clause_list[c].search_weight;
+        count[problem.hard_list[c]] += 1;
+    }
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        double mean_weight = sum_weight[problem.hard_list[c]] / count[problem.hard_list[c]];
+        weight_t weight = solution.clause_list[c].search_weight;
+        weight_t new_weight = std::max(weight_t(1), weight_t(std::llround(SAPS_RHO * weight + (1 - SAPS_RHO) * mean_weight)));
+        if (new_weight != weight) {
+            add_search_weight(problem, solution, c, new_weight - weight);
+        }
+    }
+}
+
+// ddfw_update - transfer weight from a satisfied neighbour (or random satisfied clause) to each unsat clause,
+// a random donor now and then breaks cycles where the flip that satisfies a clause unsatisfies its donor
+void ddfw_update(const problem& problem, solution& solution, rand_t rand) {
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    // weight transfers do not change which clauses are unsat, so the list is stable
+    for (uint64_t i=0; i < unsat_list.size(); i++) {
+        uint64_t c = unsat_list[i];
+        bool hard = problem.hard_list[c];
+        // satisfied clause of the same kind sharing a literal with the most weight
+        uint64_t donor = c;
+        weight_t donor_weight = 0;
+        for (lit_t lit : get_clause(problem, c)) {
+            for (uint64_t c2 : get_occur(problem, lit)) {
+                if (solution.clause_list[c2].sat_count > 0 and problem.hard_list[c2] == hard and solution.clause_list[c2].search_weight > donor_weight) {
+                    donor = c2;
+                    donor_weight = solution.clause_list[c2].search_weight;
+                }
+            }
+        }
+        if (donor == c or donor_weight < initial_search_weight(problem, donor, DDFW_BASE_WEIGHT) or rand() < DDFW_RANDOM_DONOR_PROB) {
+            for (uint64_t k=0; k < DDFW_DONOR_TRIES; k++) {
+                uint64_t c2 = uint64_t(rand() * problem.num_clauses);
+                if (solution.clause_list[c2].sat_count > 0 and problem.hard_list[c2] == hard and solution.clause_list[c2].search_weight >= initial_search_weight(problem, c2, DDFW_BASE_WEIGHT)) {
+                    donor = c2;
+                    donor_weight = solution.clause_list[c2].search_weight;
+                    break;
+                }
+            }
+        }
+        if (donor == c or donor_weight <= 1) {
+            continue;
+        }
+        weight_t amount = donor_weight > initial_search_weight(problem, donor, DDFW_BASE_WEIGHT) ? 2 : 1;
+        add_search_weight(problem, solution, donor, -amount);
+        add_search_weight(problem, solution, c, +amount);
+    }
+}
+
+// swt_update - additive increase of unsat clauses, scale every weight of the kind towards the mean once it exceeds
+// the threshold, times the mean the kind started from
+WALKSAT_MULTIVERSION void swt_update(const problem& problem, solution& solution, const weighting_state& state) {
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    bool hard = solution.clause_unsat_hard_idx_list.size() > 0;
+    for (uint64_t i=0; i < unsat_list.size(); i++) {
+        add_search_weight(problem, solution, unsat_list[i], +1);
+    }
+    uint64_t count = hard ? problem.num_hard_clauses : problem.num_clauses - problem.num_hard_clauses;
+    double mean_weight = double(hard ? solution.sum_search_weight_hard : solution.sum_search_weight_soft) / count;
+    if (mean_weight <= SWT_THRESHOLD * (hard ? SWT_BASE_WEIGHT : state.initial_mean_soft)) {
+        return;
+    }
+    for (uint64_t c=0; c < problem.num_clauses; c++) {
+        if (problem.hard_list[c] != hard) {
+            continue;
+        }
+        weight_t weight = solution.clause_list[c].search_weight;
+        weight_t new_weight = std::max(weight_t(1), weight_t(SWT_P * weight + SWT_Q * mean_weight));
+        if (new_weight != weight) {
+            add_search_weight(problem, solution, c, new_weight - weight);
+        }
+    }
+}
+
+// update_search_weight - update clause weights at a local minimum
+void update_search_weight(const problem& problem, solution& solution, rand_t rand, uint64_t weighting, weighting_state& state) {
+    switch (weighting) {
+        case WALKSAT_WEIGHTING_SAPS:
+            saps_update(problem, solution, rand);
+            break;
+        case WALKSAT_WEIGHTING_DDFW:
+            ddfw_update(problem, solution, rand);
+            break;
+        case WALKSAT_WEIGHTING_SWT:
+            swt_update(problem, solution, state);
+            break;
+        default:
+            paws_update(problem, solution, state);
+            break;
+    }
+}
+
+// pick_sideways_var - uniformly random var of an unsat clause whose flip leaves the weighted cost unchanged,
+// 0 if there is none
+var_t pick_sideways_var(const problem& problem, const solution& solution, rand_t rand, tabu_state& tabu) {
+    var_t flip_var = 0;
+    uint64_t num_sideways = 0;
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    for (uint64_t i=0; i < unsat_list.size(); i++) {
+        for (lit_t lit : get_clause(problem, unsat_list[i])) {
+            var_t var = abs(lit);
+            if (solution.var_list[var].flip_hard_change != 0 or solution.var_list[var].flip_weight_change != 0) {
+                continue;
+            }
+            if (not tabu_allowed(problem, solution, tabu, var)) {
+                continue;
+            }
+            // reservoir sampling, a var of several unsat clauses is proportionally more likely
+            num_sideways++;
+            if (rand() * num_sideways < 1) {
+                flip_var = var;
+            }
+        }
+    }
+    return flip_var;
+}
+
+// weighting_pick_var - best improving var, at a local minimum update clause weights and pick var in random unsat clause,
+// DDFW instead takes a sideways var with DDFW_SIDEWAYS_PROB, otherwise transfers weight and returns 0 to flip nothing
+var_t weighting_pick_var(const problem& problem, solution& solution, rand_t rand, double random_flip_prob, uint64_t weighting, weighting_state& state, tabu_state& tabu) {
+    var_t flip_var = pick_improving_var(problem, solution, tabu, false);
+    if (flip_var != 0) {
+        return flip_var;
+    }
+    if (weighting == WALKSAT_WEIGHTING_DDFW) {
+        if (rand() < DDFW_SIDEWAYS_PROB) {
+            flip_var = pick_sideways_var(problem, solution, rand, tabu);
+            if (flip_var != 0) {
+                return flip_var;
+            }
+        }
+        ddfw_update(problem, solution, rand);
+        return 0;
+    }
+    // local minimum
+    update_search_weight(problem, solution, rand, weighting, state);
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    uint64_t c = unsat_list[uint64_t(rand() * unsat_list.size())];
+    clause_view clause = get_clause(problem, c);
+    if (rand() < random_flip_prob) {
+        return pick_random_var(problem, solution, tabu, clause, rand);
+    }
+    return pick_best_var(problem, solution, tabu, c);
+}
+
+// novelty_pick_var - Novelty+, with random_flip_prob a random var in the clause, otherwise the best var
+// unless it is the most recently flipped var in the clause, then with noise the second best var
+var_t novelty_pick_var(const problem& problem, solution& solution, rand_t rand, double random_flip_prob, double noise, tabu_state& tabu) {
+    uint64_t c = walksat_pick_clause(problem, solution, rand);
+    clause_view clause = get_clause(problem, c);
+    if (rand() < random_flip_prob) {
+        return pick_random_var(problem, solution, tabu, clause, rand);
+    }
+    var_t best_var = 0;
+    var_t second_var = 0;
+    var_t youngest_var = 0;
+    for (lit_t lit : clause) {
+        var_t var = abs(lit);
+        if (youngest_var == 0 or solution.var_list[var].flip_step > solution.var_list[youngest_var].flip_step) {
+            youngest_var = var;
+        }
+        if (not tabu_allowed(problem, solution, tabu, var)) {
+            continue;
+        }
+        if (best_var == 0 or better_var(solution, var, best_var)) {
+            second_var = best_var;
+            best_var = var;
+        } else if (second_var == 0 or better_var(solution, var, second_var)) {
+            second_var = var;
+        }
+    }
+    if (best_var == 0) {
+        return oldest_var(solution, clause);
+    }
+    if (best_var != youngest_var or second_var == 0 or rand() >= noise) {
+        return best_var;
+    }
+    return second_var;
+}
+
+struct cc_state {
+    arena_vector<bool> conf_changed; // some neighbour of var[i] was flipped since var[i] was last flipped
+};
+
+// cc_flip - var and every var sharing a clause with it changed configuration, var itself is reset
+void cc_flip(const problem& problem, cc_state& state, var_t var) {
+    auto clause_literals = [&problem](uint64_t c) { return problem.lit_list.data() + problem.clause_start[c]; };
+    for (uint64_t k=0; k < 2; k++) {
+        lit_t lit = k == 0 ? lit_t(var) : -lit_t(var);
+        list_view<uint64_t> occur = get_occur(problem, lit);
+        for (uint64_t i=0; i < occur.size(); i++) {
+            prefetch_ahead(occur, i, clause_literals);
+            for (lit_t other : get_clause(problem, occur[i])) {
+                state.conf_changed[abs(other)] = true;
+            }
+        }
+    }
+    state.conf_changed[var] = false;
+}
+
+// significant_var - flipping var decreases the search cost by more than the mean clause weight
+bool significant_var(const problem& problem, const solution& solution, var_t var) {
+    weight_t hard_change = solution.var_list[var].flip_hard_change;
+    if (hard_change != 0) {
+        return -hard_change * weight_t(problem.num_hard_clauses) > solution.sum_search_weight_hard;
+    }
+    uint64_t num_soft_clauses = problem.num_clauses - problem.num_hard_clauses;
+    return -solution.var_list[var].flip_weight_change * weight_t(num_soft_clauses) > solution.sum_search_weight_soft;
+}
+
+// cc_pick_var - CCAnr, best improving var whose configuration changed, otherwise the best
+// significantly improving var (aspiration), otherwise update clause weights and pick the oldest var in a random unsat clause
+var_t cc_pick_var(const problem& problem, solution& solution, rand_t rand, double random_flip_prob, uint64_t weighting, weighting_state& weight_state, const cc_state& state, tabu_state& tabu) {
+    var_t ccd_var = 0;
+    var_t aspiration_var = 0;
+    // improving vars are a superset of the CCD vars, stale entries are removed on the way
+    for (uint64_t i=solution.improving_var_list.size(); i > 0; i--) {
+        var_t var = solution.improving_var_list[i-1];
+        if (not improving_var(solution, var)) {
+            solution.var_list[var].improving_listed = false;
+            solution.improving_var_list[i-1] = solution.improving_var_list.back();
+            solution.improving_var_list.pop_back();
+            continue;
+        }
+        if (state.conf_changed[var]) {
+            if ((ccd_var == 0 or better_var(solution, var, ccd_var)) and tabu_allowed(problem, solution, tabu, var)) {
+                ccd_var = var;
+            }
+        } else if (ccd_var == 0 and significant_var(problem, solution, var)) {
+            if ((aspiration_var == 0 or better_var(solution, var, aspiration_var)) and tabu_allowed(problem, solution, tabu, var)) {
+                aspiration_var = var;
+            }
+        }
+    }
+    if (ccd_var != 0) {
+        return ccd_var;
+    }
+    if (aspiration_var != 0) {
+        return aspiration_var;
+    }
+    // local minimum
+    update_search_weight(problem, solution, rand, weighting, weight_state);
+    const arena_vector<uint64_t>& unsat_list = unsat_search_list(solution);
+    clause_view clause = get_clause(problem, unsat_list[uint64_t(rand() * unsat_list.size())]);
+    if (rand() < random_flip_prob) {
+        return pick_random_var(problem, solution, tabu, clause, rand);
+    }
+    // the oldest var of the clause, as in Swcc, it is the least tabu one
+    return oldest_var(solution, clause);
+}
+
+// Adaptive Novelty+ parameters
+const double NOVELTY_ADAPT_THETA = 1.0 / 6; // stagnation after THETA * num_clauses flips without improvement
+const double NOVELTY_ADAPT_PHI = 0.2;
+
+struct novelty_state {
+    double noise;
+    uint64_t adapt_step; // num_flips at the last noise change
+    uint64_t adapt_hard; // cost at the last noise change
+    weight_t adapt_weight;
+};
+
+// adapt_novelty_noise - increase noise on stagnation, decrease it on improvement
+void adapt_novelty_noise(const problem& problem, const solution& solution, novelty_state& state) {
+    if (less_cost(solution.assignment_hard, solution.assignment_weight, state.adapt_hard, state.adapt_weight)) {
+        state.noise -= state.noise * NOVELTY_ADAPT_PHI / 2;
+    } else if (solution.num_flips - state.adapt_step > NOVELTY_ADAPT_THETA * problem.num_clauses) {
+        state.noise += (1 - state.noise) * NOVELTY_ADAPT_PHI;
+    } else {
+        return;
+    }
+    state.adapt_step = solution.num_flips;
+    state.adapt_hard = solution.assignment_hard;
+    state.adapt_weight = solution.assignment_weight;
+}
+
+// probSAT parameters, defaults per clause width from the probSAT reference implementation
+const uint64_t PROBSAT_MAX_WIDTH = 7; // wider clauses use the tables of this width
+const uint64_t PROBSAT_MAX_BREAK = 64; // larger break counts use the last entry
+
+struct probsat_table {
+    std::vector<std::vector<double>> break_prob; // break_prob[width][break], unnormalized probability of picking var
+};
+
+// make_probsat_table - polynomial (eps + break)^-cb or exponential cb^-break for every clause width
+void make_probsat_table(probsat_table& table, uint64_t function, double cb) {
+    table.break_prob.assign(PROBSAT_MAX_WIDTH + 1, std::vector<double>(PROBSAT_MAX_BREAK + 1, 1.0));
+    for (uint64_t width=1; width <= PROBSAT_MAX_WIDTH; width++) {
+        bool poly = function == WALKSAT_PROBSAT_POLY or (function == WALKSAT_PROBSAT_AUTO and width <= 3);
+        double width_cb = cb;
+        if (width_cb <= 0) {
+            const double default_cb[PROBSAT_MAX_WIDTH + 1] = {2.06, 2.06, 2.06, 2.06, 3.0, 3.7, 5.1, 5.4};
+            width_cb = default_cb[width];
+        }
+        for (uint64_t b=0; b <= PROBSAT_MAX_BREAK; b++) {
+            if (poly) {
+                table.break_prob[width][b] = std::pow(0.9 + b, -width_cb);
+            } else {
+                table.break_prob[width][b] = std::pow(width_cb, -double(b));
+            }
+        }
+    }
+}
+
+// probsat_pick_var - pick var in random unsat clause with probability by its break count,
+// a single pass of weighted reservoir sampling over the clause
+var_t probsat_pick_var(const problem& problem, solution& solution, rand_t rand, const probsat_table& table, tabu_state& tabu) {
+    uint64_t c = walksat_pick_clause(problem, solution, rand);
+    clause_view clause = get_clause(problem, c);
+    bool hard = problem.hard_list[c];
+    const std::vector<double>& break_prob = table.break_prob[std::min<uint64_t>(clause.size(), PROBSAT_MAX_WIDTH)];
+    var_t flip_var = 0;
+    double sum_prob = 0;
+    for (lit_t lit : clause) {
+        var_t var = abs(lit);
+        if (not tabu_allowed(problem, solution, tabu, var)) {
+            continue;
+        }
+        // repairing a soft clause must not break hard clauses either
+        uint64_t num_break = hard ? solution.var_list[var].break_hard : solution.var_list[var].break_hard + solution.var_list[var].break_soft;
+        double prob = break_prob[std::min(num_break, PROBSAT_MAX_BREAK)];
+        sum_prob += prob;
+        if (rand() * sum_prob < prob) {
+            flip_var = var;
+        }
+    }
+    if (flip_var == 0) {
+        return oldest_var(solution, clause);
+    }
+    return flip_var;
+}
+
+// luby - i-th element (from 1) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+uint64_t luby(uint64_t i) {
+    while (true) {
+        uint64_t k = 1;
+        while ((uint64_t(1) << k) - 1 < i) {
+            k++;
+        }
+        if ((uint64_t(1) << k) - 1 == i) {
+            return uint64_t(1) << (k - 1);
+        }
+        i -= (uint64_t(1) << (k - 1)) - 1;
+    }
+}
+
+struct restart_state {
+    uint64_t num_restarts;
+    uint64_t last_restart; // flips at the last restart
+    uint64_t last_improve; // flips at the last improvement of the best cost
+    uint64_t interval; // flips between the last restart and the next one, for luby and geometric
+};
+
+// restart_interval - flips before the next scheduled restart, at least one so that every restart is followed by a flip
+uint64_t restart_interval(const walksat_config& config, uint64_t num_restarts) {
+    uint64_t interval;
+    switch (config.restart_policy) {
+        case WALKSAT_RESTART_LUBY:
+            interval = config.restart_base * luby(num_restarts + 1);
+            break;
+        case WALKSAT_RESTART_GEOMETRIC:
+            interval = uint64_t(config.restart_base * std::pow(config.restart_factor, double(num_restarts)));
+            break;
+        default:
+            interval = config.restart_base;
+            break;
+    }
+    return std::max(interval, uint64_t(1));
+}
 
+// restart_due - luby and geometric restart on schedule, stagnation restarts after restart_base flips without improvement
+bool restart_due(const walksat_config& config, const restart_state& restart, uint64_t num_flips) {
+    switch (config.restart_policy) {
+        case WALKSAT_RESTART_LUBY:
+        case WALKSAT_RESTART_GEOMETRIC:
+            return num_flips - restart.last_restart >= restart.interval;
+        case WALKSAT_RESTART_STAGNATION:
+            return num_flips - std::max(restart.last_restart, restart.last_improve) >= restart.interval;
+        default:
+            return false;
+    }
+}
+
+// restart_solution - new random assignment, the best assignment (phase saving) or a perturbation of it
+void restart_solution(const problem& problem, solution& solution, const assign_t& best_assignment, const walksat_config& config, rand_t rand) {
+    switch (config.restart_init) {
+        case WALKSAT_RESTART_INIT_BEST:
+        case WALKSAT_RESTART_INIT_PERTURB: {
+            set_assignment(solution, best_assignment);
+            if (config.restart_init == WALKSAT_RESTART_INIT_PERTURB) {
+                uint64_t num_perturb = uint64_t(std::ceil(config.restart_perturb * problem.num_variables));
+                for (uint64_t k=0; k < num_perturb; k++) {
+                    var_t var = 1 + uint64_t(rand() * problem.num_variables);
+                    solution.var_list[var].value *= -1;
+                }
+            }
+            break;
+        }
+        default:
+            init_solution(problem, solution, rand);
+            break;
+    }
+}
+
+const uint64_t TIME_CHECK_PERIOD = 1024; // flips between clock reads
+
+// search_huge_page_bytes - huge page backed bytes of the mappings holding the arrays of a search that
+// asked for huge pages, smaller arrays never ask so that small components skip the measurement
+uint64_t search_huge_page_bytes(const problem& problem, const arena& pool) {
+    if (not pool.huge_pages) {
+        return 0;
+    }
+    std::vector<const void*> address_list;
+    if (pool.size >= HUGE_PAGE_SIZE) {
+        address_list.push_back(pool.data);
+    }
+    if (problem.lit_list.capacity() * sizeof(lit_t) >= HUGE_PAGE_SIZE) {
+        address_list.push_back(problem.lit_list.data());
+    }
+    if (problem.clause_start.capacity() * sizeof(uint64_t) >= HUGE_PAGE_SIZE) {
+        address_list.push_back(problem.clause_start.data());
+    }
+    if (problem.occur_list.capacity() * sizeof(uint64_t) >= HUGE_PAGE_SIZE) {
+        address_list.push_back(problem.occur_list.data());
+    }
+    if (address_list.empty()) {
+        return 0;
+    }
+    return huge_page_bytes(address_list);
+}
+
+// local_search_problem - search until the target is met or the deadline passes, return the best assignment,
+// the search of a component of a larger problem starts from search->initial_assignment if it has one, reports its
+// best costs to search->target and also stops once that is reached
+assign_t local_search_problem(const problem& problem, const walksat_config& config, weight_t target_weight, steady_clock::time_point deadline, walksat_stats& stats, const component_search* search) {
+    if (config.engine == WALKSAT_ENGINE_MULTIWALK) {
+        return multiwalk_search_problem(problem, config, target_weight, deadline, stats, search);
+    }
+    // every array the search writes to is carved from one block sized up front, so that the search loop
+    // allocates nothing
+    uint64_t arena_size = solution_arena_size(problem)
+        + arena_array_size<uint64_t>(problem.num_clauses) + arena_array_size<bool>(problem.num_clauses) // weighting_state
+        + arena_array_size<bool>(problem.num_variables + 1) // cc_state
+        + arena_array_size<var_t>(problem.num_variables + 1); // best_changed_list
+    arena pool;
+    init_arena(pool, arena_size, config.huge_pages != 0);
     solution solution;
+    reserve_solution(problem, solution, pool);
 
     std::uniform_real_distribution<double> dist_float01(0, 1);
-    std::mt19937_64 engine(seed);
+    std::mt19937_64 engine(config.seed);
 
     rand_t rand = [&engine, &dist_float01]() -> double {
         return dist_float01(engine);
     };
 
-    init_solution(problem, solution, rand);
-    uint64_t start_time_s = std::time(nullptr);
+    bool weighting = config.engine == WALKSAT_ENGINE_WEIGHTING or config.engine == WALKSAT_ENGINE_CC;
+    probsat_table table;
+    if (config.engine == WALKSAT_ENGINE_PROBSAT) {
+        make_probsat_table(table, config.probsat_function, config.probsat_cb);
+    }
+    weight_t base_weight = weighting ? base_search_weight(config.weighting) : 1;
+    weighting_state state;
+    state.heavy_clause_list = arena_vector<uint64_t>(arena_allocator<uint64_t>(&pool));
+    state.heavy_clause_list.reserve(problem.num_clauses);
+    state.heavy_clause = arena_vector<bool>(problem.num_clauses, false, arena_allocator<bool>(&pool));
+    cc_state cc;
+    cc.conf_changed = arena_vector<bool>(problem.num_variables + 1, true, arena_allocator<bool>(&pool));
+    tabu_state tabu;
+    tabu.tenure = config.tabu_tenure;
+    tabu.base_tenure = config.tabu_tenure;
+    tabu.max_tenure = std::max<uint64_t>(4 * config.tabu_tenure, TABU_MIN_MAX_TENURE);
+    tabu.adaptive = config.tabu_adaptive != 0;
+    tabu.num_blocked = 0;
+    stats.num_promising_flips = 0;
+    novelty_state adaptive;
+    adaptive.noise = config.engine == WALKSAT_ENGINE_ADAPTIVE_NOVELTY ? 0 : config.novelty_noise;
+
+    if (search != nullptr and not search->initial_assignment.empty()) {
+        set_assignment(solution, search->initial_assignment);
+    } else {
+        switch (config.init) {
+            case WALKSAT_INIT_POLARITY: {
+                assign_t polarity;
+                get_polarity(problem, polarity);
+                init_polarity_solution(problem, polarity, solution, rand);
+                break;
+            }
+            case WALKSAT_INIT_GREEDY:
+                init_greedy_solution(problem, solution, rand);
+                break;
+            default:
+                init_solution(problem, solution, rand);
+                break;
+        }
+    }
+    init_search_weight(problem, solution, base_weight);
+    if (problem.num_clauses > problem.num_hard_clauses) {
+        state.initial_mean_soft = std::max(1.0, double(solution.sum_search_weight_soft) / (problem.num_clauses - problem.num_hard_clauses));
+    }
+    eval_solution(problem, solution);
+    stats.initial_hard_cost = solution.assignment_hard;
+    stats.initial_soft_cost = solution.assignment_weight; // scaled back by c_walksat
+    adaptive.adapt_step = 0;
+    adaptive.adapt_hard = solution.assignment_hard;
+    adaptive.adapt_weight = solution.assignment_weight;
+    tabu.adapt_step = 0;
+    tabu.adapt_hard = solution.assignment_hard;
+    tabu.adapt_weight = solution.assignment_weight;
     uint64_t loop_count = 0;
+    uint64_t num_flips = 0; // loop_count also counts restarts and steps that only change weights
 
-    uint64_t best_assignment_weight = std::numeric_limits<uint64_t>::max();
+    uint64_t best_assignment_hard = std::numeric_limits<uint64_t>::max();
+    weight_t best_assignment_weight = std::numeric_limits<weight_t>::max();
     assign_t best_assignment(problem.num_variables+1);
+    // vars flipped since best_assignment was last brought up to date, so that a new best costs
+    // the flips since the last one rather than a copy of every var, a full copy once it outgrows the vars
+    arena_vector<var_t> best_changed_list((arena_allocator<var_t>(&pool)));
+    best_changed_list.reserve(problem.num_variables + 1);
+    bool best_copy_all = true;
+    tabu.best_hard = best_assignment_hard;
+    tabu.best_weight = best_assignment_weight;
+    restart_state restart;
+    restart.num_restarts = 0;
+    restart.last_restart = 0;
+    restart.last_improve = 0;
+    restart.interval = restart_interval(config, 0);
 
+    steady_clock::time_point search_start = steady_clock::now();
+    uint64_t start_allocations = pool.num_allocations;
     while (true) {
         loop_count++;
 
-        eval_solution(problem, solution);
-        if (solution.assignment_weight == 0.0) {
-            return solution;
+        if (less_cost(solution.assignment_hard, solution.assignment_weight, best_assignment_hard, best_assignment_weight)) {
+            if (search != nullptr) {
+                report_component_best(*search->target, search->component, solution.assignment_hard, solution.assignment_weight);
+            }
+            best_assignment_hard = solution.assignment_hard;
+            best_assignment_weight = solution.assignment_weight;
+            if (best_copy_all) {
+                get_assignment(solution, best_assignment);
+                best_copy_all = false;
+            } else {
+                for (var_t var : best_changed_list) {
+                    best_assignment[var] = solution.var_list[var].value;
+                }
+            }
+            best_changed_list.clear();
+            tabu.best_hard = best_assignment_hard;
+            tabu.best_weight = best_assignment_weight;
+            restart.last_improve = num_flips;
         }
 
-        if (solution.assignment_weight < best_assignment_weight) {
-            best_assignment_weight = solution.assignment_weight;
-            copy_vector(best_assignment, solution.assignment);
+        if (solution.assignment_hard == 0 and (solution.assignment_weight <= target_weight or solution.clause_unsat_idx_list.empty())) {
+            // good enough, stop early and release the worker
+            stats.num_flips = num_flips;
+            stats.num_tabu_blocked = tabu.num_blocked;
+            stats.num_restarts = restart.num_restarts;
+            stats.search_time_s = std::chrono::duration<double>(steady_clock::now() - search_start).count();
+            stats.num_search_allocations = pool.num_allocations - start_allocations;
+            stats.huge_page_bytes = search_huge_page_bytes(problem, pool);
+            assign_t assignment;
+            get_assignment(solution, assignment);
+            return assignment;
         }
 
-        uint64_t time_s = std::time(nullptr);
-        if (time_s > start_time_s + max_time_s) {
-            std::cout << "timeout: loop_count " << loop_count << std::endl;
-            solution.assignment_weight = best_assignment_weight;
-            copy_vector(solution.assignment, best_assignment);
-            return solution;
+        // the deadline passed or the components searched alongside met the target together
+        if (loop_count % TIME_CHECK_PERIOD == 0 and (steady_clock::now() > deadline or (search != nullptr and search->target->reached))) {
+            stats.num_flips = num_flips;
+            stats.num_tabu_blocked = tabu.num_blocked;
+            stats.num_restarts = restart.num_restarts;
+            stats.search_time_s = std::chrono::duration<double>(steady_clock::now() - search_start).count();
+            stats.num_search_allocations = pool.num_allocations - start_allocations;
+            stats.huge_page_bytes = search_huge_page_bytes(problem, pool);
+            return best_assignment;
         }
 
-        if (rand() < reset_prob) { // reset and search again
-            init_solution(problem, solution, rand);
+        if (restart_due(config, restart, num_flips)) { // restart and search again
+            restart_solution(problem, solution, best_assignment, config, rand);
+            eval_solution(problem, solution);
+            best_changed_list.clear();
+            best_copy_all = true;
+            restart.num_restarts++;
+            restart.last_restart = num_flips;
+            restart.interval = restart_interval(config, restart.num_restarts);
+            adaptive.adapt_step = 0;
+            tabu.adapt_step = 0;
+            cc.conf_changed.assign(problem.num_variables + 1, true);
             continue;
         }
 
         // flip
-        // pick random unsat clause according to weight
-        make_clause_unsat_dist(problem, solution);
-        uint64_t i = weighted_random(solution.clause_unsat_idx_dist, rand());
-        uint64_t c = solution.clause_unsat_idx_list[i];
-        const clause_t& clause = problem.clause_list[c];
-        var_t flip_var;
-        if (rand() < random_flip_prob) {
-            // with random_flip_prob, pick random var uniformly in clause
-            flip_var = abs(clause[uint64_t(rand() * clause.size())]);
-        } else {
-            // pick the var with most weight change
-            weight_t best_weight_change = std::numeric_limits<double>::max();
-            for (lit_t lit : clause) {
-                var_t var = abs(lit);
-                if (solution.var_flip_weight_change[var] < best_weight_change) {
-                    best_weight_change = solution.var_flip_weight_change[var];
-                    flip_var = var;
-                }
-            }
+        if (tabu.adaptive) {
+            adapt_tabu_tenure(problem, solution, tabu);
+        }
+        var_t flip;
+        switch (config.engine) {
+            case WALKSAT_ENGINE_WEIGHTING:
+                flip = weighting_pick_var(problem, solution, rand, config.rand_var_prob, config.weighting, state, tabu);
+                break;
+            case WALKSAT_ENGINE_PROBSAT:
+                flip = probsat_pick_var(problem, solution, rand, table, tabu);
+                break;
+            case WALKSAT_ENGINE_ADAPTIVE_NOVELTY:
+                adapt_novelty_noise(problem, solution, adaptive);
+                flip = novelty_pick_var(problem, solution, rand, config.rand_var_prob, adaptive.noise, tabu);
+                break;
+            case WALKSAT_ENGINE_NOVELTY:
+                flip = novelty_pick_var(problem, solution, rand, config.rand_var_prob, adaptive.noise, tabu);
+                break;
+            case WALKSAT_ENGINE_CC:
+                flip = cc_pick_var(problem, solution, rand, config.rand_var_prob, config.weighting, state, cc, tabu);
+                cc_flip(problem, cc, flip);
+                break;
+            default:
+                flip = walksat_pick_var(problem, solution, rand, config.rand_var_prob, tabu, config.walksat_promising != 0, stats.num_promising_flips);
+                break;
+        }
+        if (flip == 0) { // weights changed instead, search again
+            continue;
         }
         // flip and repeat
-        solution.assignment[flip_var] *= -1;
+        flip_var(problem, solution, flip);
+        num_flips++;
+        if (not best_copy_all) {
+            best_changed_list.push_back(flip);
+            if (best_changed_list.size() > problem.num_variables) {
+                best_changed_list.clear();
+                best_copy_all = true;
+            }
+        }
     }
 }
 
+const double SETUP_TIME_SHARE = 0.25; // of max_time_s, preprocessing and reordering are cut short or skipped past it
+const double MIN_SEARCH_TIME_SHARE = 0.5; // of max_time_s, search gets at least this much once setup is done
+
+// search_budget - time of a call. Setup that can be left out stops at setup_deadline, search starts once setup is
+// done and runs until deadline, or for min_search if setup left less than that
+struct search_budget {
+    steady_clock::time_point setup_deadline;
+    steady_clock::time_point deadline;
+    steady_clock::duration min_search;
+};
+
+// make_search_budget - budget of a call of max_time_s seconds starting now
+search_budget make_search_budget(double max_time_s) {
+    steady_clock::time_point now = steady_clock::now();
+    search_budget budget;
+    budget.setup_deadline = now + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(max_time_s * SETUP_TIME_SHARE));
+    budget.deadline = now + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(max_time_s));
+    budget.min_search = std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(max_time_s * MIN_SEARCH_TIME_SHARE));
+    return budget;
+}
+
+// search_deadline - deadline of a search starting now
+steady_clock::time_point search_deadline(const search_budget& budget) {
+    return std::max(budget.deadline, steady_clock::now() + budget.min_search);
+}
+
+// search_component - local search on problem, renumbered for locality first if config.reorder is set and
+// the setup budget is not used up
+assign_t search_component(problem& problem, const walksat_config& config, weight_t target_weight, const search_budget& budget, walksat_stats& stats) {
+    if (config.reorder == 0 or steady_clock::now() > budget.setup_deadline) {
+        make_occur_list(problem);
+        return local_search_problem(problem, config, target_weight, search_deadline(budget), stats, nullptr);
+    }
+    struct problem reordered;
+    std::vector<var_t> var_list;
+    reorder_problem(problem, reordered, var_list);
+    make_occur_list(reordered);
+    assign_t reordered_assignment = local_search_problem(reordered, config, target_weight, search_deadline(budget), stats, nullptr);
+    assign_t assignment(problem.num_variables + 1, 0);
+    for (var_t var=1; var <= problem.num_variables; var++) {
+        assignment[var_list[var]] = reordered_assignment[var];
+    }
+    return assignment;
+}
+
+// add_search_stats - add the counters of a search to stats
+void add_search_stats(walksat_stats& stats, const walksat_stats& search_stats) {
+    stats.num_flips += search_stats.num_flips;
+    stats.num_tabu_blocked += search_stats.num_tabu_blocked;
+    stats.num_promising_flips += search_stats.num_promising_flips;
+    stats.num_restarts += search_stats.num_restarts;
+    stats.search_time_s += search_stats.search_time_s;
+    stats.num_search_allocations += search_stats.num_search_allocations;
+}
+
+// search_problem - search every connected component of problem on its own, largest first on up to
+// config.num_threads threads. The components report their best costs to a shared target and every search
+// stops once the costs add up to at most target_weight, so slack one component does not need goes to the others.
+// With fewer threads than components a short first pass gives every component a best cost before any of them
+// searches long, the second pass carries on from there. A component gets a share of the time left in proportion
+// to its literals, time it does not use goes to the components after it. The time is shared out once every
+// component is set up
+assign_t search_problem(problem& problem, const walksat_config& config, weight_t target_weight, const search_budget& budget, walksat_stats& stats) {
+    std::vector<uint64_t> var_component;
+    uint64_t num_components = find_components(problem, var_component);
+    stats.num_components = num_components;
+    if (num_components <= 1) {
+        return search_component(problem, config, target_weight, budget, stats);
+    }
+    std::vector<struct problem> component_list;
+    std::vector<std::vector<var_t>> component_var_list;
+    split_components(problem, var_component, num_components, component_list, component_var_list);
+
+    std::vector<uint64_t> order(num_components);
+    for (uint64_t i=0; i < num_components; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&component_list](uint64_t a, uint64_t b) {
+        return component_list[a].lit_list.size() > component_list[b].lit_list.size();
+    });
+
+    // literals of the components from the k-th in order on, time is shared by them
+    std::vector<uint64_t> lit_count_left(num_components + 1, 0);
+    for (uint64_t k=num_components; k > 0; k--) {
+        lit_count_left[k-1] = lit_count_left[k] + component_list[order[k-1]].lit_list.size() + 1;
+    }
+
+    uint64_t num_threads = config.num_threads != 0 ? config.num_threads : std::max<uint64_t>(1, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, num_components);
+    // for_each_component - call fn(k) for the k-th component in order on num_threads threads
+    auto for_each_component = [&](const std::function<void(uint64_t)>& fn) {
+        std::atomic<uint64_t> next(0);
+        auto worker = [&]() {
+            for (uint64_t k = next++; k < num_components; k = next++) {
+                fn(k);
+            }
+        };
+        std::vector<std::thread> thread_list;
+        for (uint64_t t=1; t < num_threads; t++) {
+            thread_list.push_back(std::thread(worker));
+        }
+        worker();
+        for (std::thread& thread : thread_list) {
+            thread.join();
+        }
+    };
+
+    // renumber every component for locality once, both passes search the renumbered one
+    for_each_component([&](uint64_t k) {
+        uint64_t i = order[k];
+        if (config.reorder != 0 and steady_clock::now() <= budget.setup_deadline) {
+            struct problem reordered;
+            std::vector<var_t> var_list;
+            reorder_problem(component_list[i], reordered, var_list);
+            for (var_t var=1; var < var_list.size(); var++) {
+                var_list[var] = component_var_list[i][var_list[var]];
+            }
+            component_list[i] = std::move(reordered);
+            component_var_list[i] = std::move(var_list);
+        }
+        make_occur_list(component_list[i]);
+    });
+    steady_clock::time_point deadline = search_deadline(budget);
+
+    component_target shared_target;
+    init_component_target(shared_target, target_weight, num_components);
+    std::vector<component_search> search_list(num_components);
+    for (uint64_t i=0; i < num_components; i++) {
+        search_list[i].target = &shared_target;
+        search_list[i].component = i;
+    }
+    std::vector<assign_t> assignment_list(num_components);
+    std::vector<walksat_stats> first_stats_list(num_components, walksat_stats());
+    bool first_pass = target_weight >= 0 and num_threads < num_components;
+    if (first_pass) {
+        // a deadline in the past stops every search at its first clock read
+        for_each_component([&](uint64_t k) {
+            uint64_t i = order[k];
+            walksat_config component_config = config;
+            component_config.seed = config.seed + i;
+            assignment_list[i] = local_search_problem(component_list[i], component_config, 0, steady_clock::time_point(), first_stats_list[i], &search_list[i]);
+            search_list[i].initial_assignment = assignment_list[i];
+        });
+    }
+
+    std::vector<walksat_stats> stats_list(num_components, walksat_stats());
+    for_each_component([&](uint64_t k) {
+        uint64_t i = order[k];
+        if (shared_target.reached) {
+            return; // the first pass or the components before met the target
+        }
+        walksat_config component_config = config;
+        component_config.seed = config.seed + i + (first_pass ? num_components : 0);
+        steady_clock::time_point now = steady_clock::now();
+        steady_clock::time_point component_deadline = deadline;
+        if (now < deadline) {
+            // every thread takes on about lit_count_left[k] / num_threads of the literals left
+            double share = double(component_list[i].lit_list.size() + 1) * num_threads / lit_count_left[k];
+            if (share < 1) {
+                component_deadline = now + std::chrono::duration_cast<steady_clock::duration>((deadline - now) * share);
+            }
+        }
+        // a component alone stops only once it has no unsat clause of positive weight left
+        assignment_list[i] = local_search_problem(component_list[i], component_config, 0, component_deadline, stats_list[i], &search_list[i]);
+    });
+
+    // stitch the components back together
+    assign_t assignment(problem.num_variables + 1, 0);
+    stats.num_flips = 0;
+    stats.num_tabu_blocked = 0;
+    stats.num_promising_flips = 0;
+    stats.num_restarts = 0;
+    stats.search_time_s = 0;
+    stats.num_search_allocations = 0;
+    stats.huge_page_bytes = 0;
+    stats.initial_hard_cost = 0;
+    stats.initial_soft_cost = 0;
+    for (uint64_t i=0; i < num_components; i++) {
+        for (var_t var=1; var < component_var_list[i].size(); var++) {
+            assignment[component_var_list[i][var]] = assignment_list[i][var];
+        }
+        add_search_stats(stats, first_stats_list[i]);
+        add_search_stats(stats, stats_list[i]);
+        // the costs a component starts from before any search, from the first pass if it ran
+        const walksat_stats& initial_stats = first_pass ? first_stats_list[i] : stats_list[i];
+        stats.huge_page_bytes += std::max(first_stats_list[i].huge_page_bytes, stats_list[i].huge_page_bytes);
+        stats.initial_hard_cost += initial_stats.initial_hard_cost;
+        stats.initial_soft_cost += initial_stats.initial_soft_cost;
+    }
+    return assignment;
+}
+
 double c_walksat(
-    uint64_t seed,
-    uint64_t max_time_s,
-    double rand_var_prob,
+    const walksat_config* config,
     uint64_t num_variables,
     uint64_t num_clauses,
     int64_t* formula_flatten,
     double* clause_weight,
-    int8_t* assignment
+    int8_t* clause_hard,
+    int8_t* assignment,
+    walksat_stats* stats
 ) {
+    // setup and search share max_time_s, search still gets its minimum if the setup that cannot be left out overruns
+    search_budget budget = make_search_budget(config->max_time_s);
+
     // make problem
+    double scale = weight_scale(num_clauses, clause_weight, clause_hard);
     problem problem;
-    problem.num_variables = num_variables;
     {
-        uint64_t i = 0;
+        // every clause ends with 0
+        uint64_t num_literals = 0;
         for (uint64_t c=0; c < num_clauses; c++) {
-            clause_t clause;
-            while (true) {
-                lit_t literal = formula_flatten[i];
-                i++;
-                if (literal == 0) {
-                    break;
-                }
-                clause.push_back(literal);
+            while (formula_flatten[num_literals + c] != 0) {
+                num_literals++;
+            }
+        }
+        init_problem(problem, num_variables, num_clauses, num_literals, config->huge_pages != 0);
+        const lit_t* first = formula_flatten;
+        for (uint64_t c=0; c < num_clauses; c++) {
+            const lit_t* last = first;
+            while (*last != 0) {
+                last++;
             }
-            problem.clause_list.push_back(clause);
+            push_clause(problem, first, last, std::llround(clause_weight[c] * scale), clause_hard[c] != 0);
+            first = last + 1;
         }
     }
+    weight_t target_weight = weight_t(std::floor(config->target_cost * scale + 1e-6));
 
-    for (uint64_t c=0; c < num_clauses; c++) {
-        problem.weight_list.push_back(clause_weight[c]);
-    }
+    // search the normalized and preprocessed problem, clauses falsified by preprocessing count towards the target
+    struct problem reduced;
+    preprocess_map map;
+    steady_clock::time_point preprocess_deadline = std::min(budget.setup_deadline, steady_clock::now()
+        + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(config->preprocess_max_time_s)));
+    preprocess_problem(problem, *config, preprocess_deadline, reduced, map, *stats);
+    assign_t reduced_assignment = search_problem(reduced, *config, target_weight - map.fixed_weight, budget, *stats);
 
-    solution solution = local_search_problem(problem, seed, max_time_s, rand_var_prob, 0.0);
+    // evaluate the reconstructed assignment on the original problem
+    assign_t original_assignment;
+    reconstruct_assignment(map, reduced_assignment, original_assignment);
+    solution solution;
+    set_assignment(solution, original_assignment);
+    init_search_weight(problem, solution, 1);
+    eval_solution(problem, solution);
 
     for (uint64_t v=0; v < num_variables+1; v++) {
-        assignment[v] = solution.assignment[v];
+        assignment[v] = original_assignment[v];
     }
 
-    return solution.assignment_weight;
-}
\ No newline at end of file
+    stats->hard_cost = solution.assignment_hard;
+    stats->soft_cost = solution.assignment_weight / scale;
+    stats->initial_hard_cost += map.fixed_hard;
+    stats->initial_soft_cost = (stats->initial_soft_cost + map.fixed_weight) / scale;
+    stats->weight_scale = scale;
+    stats->num_lanes = config->engine == WALKSAT_ENGINE_MULTIWALK ? MULTIWALK_LANES : 1;
+    stats->lane_flips_per_s = stats->search_time_s > 0 ? stats->num_flips / stats->search_time_s : 0;
+    return stats->soft_cost;
+}
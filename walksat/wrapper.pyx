@@ -2,75 +2,334 @@
 cimport libc.stdint as stdint
 
 cdef extern from "walksat.h":
+    cdef enum walksat_engine:
+        WALKSAT_ENGINE_WALKSAT
+        WALKSAT_ENGINE_WEIGHTING
+        WALKSAT_ENGINE_PROBSAT
+        WALKSAT_ENGINE_NOVELTY
+        WALKSAT_ENGINE_ADAPTIVE_NOVELTY
+        WALKSAT_ENGINE_CC
+        WALKSAT_ENGINE_MULTIWALK
+
+    cdef enum walksat_weighting:
+        WALKSAT_WEIGHTING_PAWS
+        WALKSAT_WEIGHTING_SAPS
+        WALKSAT_WEIGHTING_DDFW
+        WALKSAT_WEIGHTING_SWT
+
+    cdef enum walksat_probsat:
+        WALKSAT_PROBSAT_AUTO
+        WALKSAT_PROBSAT_POLY
+        WALKSAT_PROBSAT_EXP
+
+    cdef enum walksat_init:
+        WALKSAT_INIT_RANDOM
+        WALKSAT_INIT_POLARITY
+        WALKSAT_INIT_GREEDY
+
+    cdef enum walksat_restart:
+        WALKSAT_RESTART_NONE
+        WALKSAT_RESTART_LUBY
+        WALKSAT_RESTART_GEOMETRIC
+        WALKSAT_RESTART_STAGNATION
+
+    cdef enum walksat_restart_init:
+        WALKSAT_RESTART_INIT_RANDOM
+        WALKSAT_RESTART_INIT_BEST
+        WALKSAT_RESTART_INIT_PERTURB
+
+    cdef enum walksat_kernel:
+        WALKSAT_KERNEL_SCALAR
+        WALKSAT_KERNEL_SSE42
+        WALKSAT_KERNEL_AVX2
+        WALKSAT_KERNEL_AVX512
+
+    cdef struct walksat_config:
+        stdint.uint64_t seed
+        double max_time_s
+        double rand_var_prob
+        double target_cost
+        stdint.uint64_t engine
+        stdint.uint64_t weighting
+        stdint.uint64_t probsat_function
+        double probsat_cb
+        double novelty_noise
+        stdint.uint64_t tabu_tenure
+        stdint.uint64_t tabu_adaptive
+        stdint.uint64_t walksat_promising
+        stdint.uint64_t init
+        stdint.uint64_t restart_policy
+        stdint.uint64_t restart_base
+        double restart_factor
+        stdint.uint64_t restart_init
+        double restart_perturb
+        stdint.uint64_t preprocess
+        stdint.uint64_t reorder
+        stdint.uint64_t num_threads
+        stdint.uint64_t huge_pages
+        double preprocess_max_time_s
+
+    cdef struct walksat_stats:
+        stdint.uint64_t hard_cost
+        double soft_cost
+        double weight_scale
+        stdint.uint64_t num_flips
+        stdint.uint64_t num_tabu_blocked
+        stdint.uint64_t num_promising_flips
+        stdint.uint64_t num_restarts
+        double search_time_s
+        stdint.uint64_t num_lanes
+        double lane_flips_per_s
+        stdint.uint64_t num_search_allocations
+        stdint.uint64_t huge_page_bytes
+        stdint.uint64_t initial_hard_cost
+        double initial_soft_cost
+        stdint.uint64_t num_duplicate_literals
+        stdint.uint64_t num_tautologies
+        stdint.uint64_t num_duplicate_clauses
+        stdint.uint64_t num_unit_vars
+        stdint.uint64_t num_pure_vars
+        stdint.uint64_t num_subsumed_clauses
+        stdint.uint64_t num_strengthened_literals
+        stdint.uint64_t num_equivalent_vars
+        stdint.uint64_t num_eliminated_vars
+        stdint.uint64_t preprocess_conflict
+        stdint.uint64_t preprocess_timeout
+        stdint.uint64_t num_reduced_variables
+        stdint.uint64_t num_reduced_clauses
+        stdint.uint64_t num_components
+
+    stdint.uint64_t walksat_kernel_variant()
+    stdint.uint64_t walksat_gather_kernel()
+    stdint.uint64_t walksat_prefetch_distance()
+
     double c_walksat(
-        stdint.uint64_t seed,
-        stdint.uint64_t max_time_s,
-        double rand_var_prob,
+        const walksat_config* config,
         stdint.uint64_t num_variables,
         stdint.uint64_t num_clauses,
         stdint.int64_t* formula_flatten,
         double* clause_weight,
-        stdint.int8_t* assignment
+        stdint.int8_t* clause_hard,
+        stdint.int8_t* assignment,
+        walksat_stats* stats
     );
 
+import time
 import numpy as np
 
+ENGINE = {
+    "walksat": WALKSAT_ENGINE_WALKSAT,
+    "weighting": WALKSAT_ENGINE_WEIGHTING,
+    "probsat": WALKSAT_ENGINE_PROBSAT,
+    "novelty": WALKSAT_ENGINE_NOVELTY,
+    "adaptive_novelty": WALKSAT_ENGINE_ADAPTIVE_NOVELTY,
+    "cc": WALKSAT_ENGINE_CC,
+    "multiwalk": WALKSAT_ENGINE_MULTIWALK,
+}
+
+WEIGHTING = {
+    "paws": WALKSAT_WEIGHTING_PAWS,
+    "saps": WALKSAT_WEIGHTING_SAPS,
+    "ddfw": WALKSAT_WEIGHTING_DDFW,
+    "swt": WALKSAT_WEIGHTING_SWT,
+}
+
+INIT = {
+    "random": WALKSAT_INIT_RANDOM,
+    "polarity": WALKSAT_INIT_POLARITY,
+    "greedy": WALKSAT_INIT_GREEDY,
+}
+
+RESTART = {
+    "none": WALKSAT_RESTART_NONE,
+    "luby": WALKSAT_RESTART_LUBY,
+    "geometric": WALKSAT_RESTART_GEOMETRIC,
+    "stagnation": WALKSAT_RESTART_STAGNATION,
+}
+
+RESTART_INIT = {
+    "random": WALKSAT_RESTART_INIT_RANDOM,
+    "best": WALKSAT_RESTART_INIT_BEST,
+    "perturb": WALKSAT_RESTART_INIT_PERTURB,
+}
+
+PROBSAT_FUNCTION = {
+    "auto": WALKSAT_PROBSAT_AUTO,
+    "poly": WALKSAT_PROBSAT_POLY,
+    "exp": WALKSAT_PROBSAT_EXP,
+}
+
+KERNEL = {
+    WALKSAT_KERNEL_SCALAR: "scalar",
+    WALKSAT_KERNEL_SSE42: "sse4.2",
+    WALKSAT_KERNEL_AVX2: "avx2",
+    WALKSAT_KERNEL_AVX512: "avx512",
+}
+
+def kernel() -> str:
+    """
+    return:
+    [kernel] - variant of the hot loops picked for this cpu at load time: "scalar", "sse4.2", "avx2" or "avx512",
+               "scalar" if the build has no target_clones
+    """
+    return KERNEL[walksat_kernel_variant()]
+
+def gather_kernel() -> str:
+    """
+    return:
+    [gather_kernel] - variant of the sat literal gather picked for this cpu: "scalar", "avx2" or "avx512"
+    """
+    return KERNEL[walksat_gather_kernel()]
+
+def prefetch_distance() -> int:
+    """
+    return:
+    [prefetch_distance] - occurrence list entries a flip prefetches ahead, set at build time with
+                          -DWALKSAT_PREFETCH_DISTANCE=n, 0 if prefetching is compiled out
+    """
+    return int(walksat_prefetch_distance())
+
 def walksat(
     formula: list[list[int]],
     weight: list[float] | None = None,
+    hard: list[bool] | None = None,
     seed: int = 1234,
-    max_time_s: int = 10,
-    rand_var_prob: float = 0.3
-) -> tuple[bool, list[int]]:
+    max_time_s: float = 10,
+    rand_var_prob: float = 0.3,
+    target_cost: float = 0.0,
+    engine: str = "walksat",
+    weighting: str = "paws",
+    probsat_function: str = "auto",
+    probsat_cb: float = 0.0,
+    novelty_noise: float = 0.5,
+    tabu_tenure: int = 0,
+    tabu_adaptive: bool = False,
+    promising: bool = False,
+    init: str = "random",
+    restart: str = "none",
+    restart_base: int = 100000,
+    restart_factor: float = 1.5,
+    restart_init: str = "random",
+    restart_perturb: float = 0.1,
+    preprocess: bool = True,
+    preprocess_max_time_s: float = 0.5,
+    reorder: bool = True,
+    num_threads: int = 0,
+    huge_pages: bool = True,
+    stats: dict | None = None,
+) -> tuple[int, float, list[int]]:
     """
     [formula] - cnf formula, for example (x_1 ∧ ¬x_2) ∨ (x_2 ∧ x_3) is [[+1, -2], [+2, +3]]
+    [weight] - weight of soft clauses
+    [hard] - whether clause must be satisfied, if both weight and hard are None, every clause is hard
     [seed] - seed for RNG in C
-    [max_time_s] - max time for walksat in seconds
-    [rand_var_prob] - probability of picking random var
+    [max_time_s] - max time for walksat in seconds, setup included: preprocessing and reorder are cut short or not
+                   started after a quarter of it and search always gets at least half of it, so only a problem whose
+                   bare setup takes more than half overruns
+    [rand_var_prob] - probability of picking random var (random walk probability for "novelty" and "adaptive_novelty")
+    [target_cost] - stop as soon as no hard clause is unsat and the weight of unsat soft clauses is at most this value
+    [engine] - "walksat", "weighting" (dynamic clause weighting), "probsat", "novelty" (Novelty+), "adaptive_novelty" (Adaptive Novelty+)
+               or "cc" (configuration checking, CCAnr), or "multiwalk" (64 WalkSAT walks with their own random choices,
+               packed into the bits of one word per var, for small formulas, only seed, max_time_s, rand_var_prob,
+               target_cost, preprocess, preprocess_max_time_s, reorder, num_threads and huge_pages apply)
+    [weighting] - clause weighting scheme of the "weighting" and "cc" engines: "paws", "saps", "ddfw" or "swt",
+                  "weighting" with "ddfw" makes sideways moves instead of random walk steps and ignores rand_var_prob
+    [probsat_function] - break function of the "probsat" engine: "auto", "poly" or "exp"
+    [probsat_cb] - base of the break function, 0.0 for the default per clause width
+    [novelty_noise] - probability of picking the second best var for "novelty", "adaptive_novelty" adjusts it itself
+    [tabu_tenure] - number of flips a flipped var stays tabu unless flipping it gives a new best, 0 disables tabu
+    [tabu_adaptive] - lengthen the tabu tenure on stagnation and shorten it back on improvement
+    [promising] - "walksat" engine flips the best promising improving var before looking at unsat clauses (G2WSAT)
+    [init] - initial assignment: "random", "polarity" (polarity with the most weighted occurrences)
+             or "greedy" (satisfy clauses one by one, hard, short and heavy first)
+    [restart] - restart schedule: "none", "luby" (restart_base * luby(i) flips), "geometric" (restart_base * restart_factor^i flips)
+                or "stagnation" (restart_base flips without improvement)
+    [restart_base] - flips, see restart
+    [restart_factor] - growth of "geometric" restart intervals
+    [restart_init] - assignment after restart: "random", "best" (phase saving) or "perturb" (best with restart_perturb of the vars flipped)
+    [restart_perturb] - fraction of vars flipped by "perturb"
+    [preprocess] - propagate hard unit clauses, remove subsumed hard clauses, substitute equivalent literals,
+                   eliminate vars of hard clauses by resolution and eliminate pure literals before search
+    [preprocess_max_time_s] - time budget of preprocessing, capped by the setup share of max_time_s, every pass stops
+                              once it is used up and the rest of the problem is kept as is (stats["preprocess_timeout"])
+    [reorder] - renumber vars and clauses in breadth first order so that a flip touches nearby memory
+    [num_threads] - threads searching independent components of the formula in parallel, 0 for every hardware thread
+    [huge_pages] - ask the kernel for transparent huge pages (madvise) for arrays of 2MB or more, fewer TLB misses on large formulas
+    [stats] - if given, filled with solver statistics
 
     return:
-    [sat] - satisfiable (1:sat, 0:unsat)
-    [assignment] - assignment if sat (+1: true, -1: false)
+    [hard_cost] - number of unsat hard clauses
+    [soft_cost] - weighted sum of unsat soft clauses
+    [assignment] - best assignment found (+1: true, -1: false)
     """
+    start = time.monotonic()
     # check
-    for clause in formula:
-        for literal in clause:
-            assert literal != 0
+    assert engine in ENGINE
+    assert weighting in WEIGHTING
+    assert probsat_function in PROBSAT_FUNCTION
+    assert init in INIT
+    assert restart in RESTART
+    assert restart_init in RESTART_INIT
+    assert restart_base >= 1
+    assert restart_factor >= 1
     # end check
-    
-    num_clauses = len(formula)
-    num_variables = 0
-    for clause in formula:
-        for literal in clause:
-            num_variables = max(num_variables, abs(literal))
-
-    assert num_variables > 0
 
+    # one pass over the formula
+    num_clauses = len(formula)
     formula_flatten = []
     for clause in formula:
-        for literal in clause:
-            formula_flatten.append(literal)
+        formula_flatten.extend(clause)
         formula_flatten.append(0)
+    formula_flatten_np = np.ascontiguousarray(np.array(formula_flatten, dtype=np.int64))
+    assert np.count_nonzero(formula_flatten_np) + num_clauses == len(formula_flatten_np)
+    num_variables = int(np.abs(formula_flatten_np).max()) if len(formula_flatten_np) > 0 else 0
+
+    assert num_variables > 0
 
+    if hard is None:
+        hard = [weight is None for _ in range(len(formula))]
     if weight is None:
         weight = [1.0 for _ in range(len(formula))]
 
-    formula_flatten_np = np.ascontiguousarray(np.array(formula_flatten, dtype=np.int64))
     weight_np = np.ascontiguousarray(np.array(weight, dtype=np.double))
+    hard_np = np.ascontiguousarray(np.array(hard, dtype=np.int8))
     assignment_np = np.ascontiguousarray(np.empty(shape=(num_variables + 1,), dtype=np.int8))
 
-    cdef stdint.uint64_t seed_c = seed
-    cdef stdint.uint64_t max_time_s_c = max_time_s
-    cdef double rand_var_prob_c = rand_var_prob
+    cdef walksat_config config_c
+    config_c.seed = seed
+    config_c.max_time_s = max(0.0, max_time_s - (time.monotonic() - start)) # copying the formula counts too
+    config_c.rand_var_prob = rand_var_prob
+    config_c.target_cost = target_cost
+    config_c.engine = ENGINE[engine]
+    config_c.weighting = WEIGHTING[weighting]
+    config_c.probsat_function = PROBSAT_FUNCTION[probsat_function]
+    config_c.probsat_cb = probsat_cb
+    config_c.novelty_noise = novelty_noise
+    config_c.tabu_tenure = tabu_tenure
+    config_c.tabu_adaptive = tabu_adaptive
+    config_c.walksat_promising = promising
+    config_c.init = INIT[init]
+    config_c.restart_policy = RESTART[restart]
+    config_c.restart_base = restart_base
+    config_c.restart_factor = restart_factor
+    config_c.restart_init = RESTART_INIT[restart_init]
+    config_c.restart_perturb = restart_perturb
+    config_c.preprocess = preprocess
+    config_c.preprocess_max_time_s = preprocess_max_time_s
+    config_c.reorder = reorder
+    config_c.num_threads = num_threads
+    config_c.huge_pages = huge_pages
     cdef stdint.uint64_t num_variables_c = num_variables
-    cdef stdint.uint64_t num_clauses_c = num_clauses 
+    cdef stdint.uint64_t num_clauses_c = num_clauses
     cdef stdint.int64_t[:] formula_flatten_c = formula_flatten_np
     cdef double[:] weight_c = weight_np
+    cdef stdint.int8_t[:] hard_c = hard_np
     cdef stdint.int8_t[:] assignment_c = assignment_np
+    cdef walksat_stats stats_c
 
-    satisfiable_c = c_walksat(seed_c, max_time_s_c, rand_var_prob_c, num_variables_c, num_clauses_c, &formula_flatten_c[0], &weight_c[0], &assignment_c[0])
-
-    satisfiable = float(satisfiable_c)
+    c_walksat(&config_c, num_variables_c, num_clauses_c, &formula_flatten_c[0], &weight_c[0], &hard_c[0], &assignment_c[0], &stats_c)
 
-    return satisfiable, [int(a) for a in assignment_np]
+    if stats is not None:
+        stats.update(stats_c)
 
+    return int(stats_c.hard_cost), float(stats_c.soft_cost), [int(a) for a in assignment_np]